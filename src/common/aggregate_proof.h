@@ -0,0 +1,366 @@
+#ifndef SRC_COMMON_AGGREGATE_PROOF_H_
+#define SRC_COMMON_AGGREGATE_PROOF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/aggregation_transcript.h"
+#include "tachyon/base/containers/container_util.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/math/elliptic_curves/msm/variable_base_msm.h"
+#include "tachyon/math/elliptic_curves/pairing/pairing.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+constexpr char kAggregationTranscriptLabel[] = "circom-groth16-aggregation";
+
+// The commitment key of the proof aggregation, made of two powers-of-tau SRS
+// for the secrets a and b:
+//
+//   gᵃⁱ, gᵇⁱ for i < 2n and hᵃⁱ, hᵇⁱ for i < n
+//
+// where n is the maximum number of proofs to aggregate. hᵃⁱ and hᵇⁱ commit to
+// A and C, the last n of gᵃⁱ and gᵇⁱ commit to B, and all of them are used to
+// open the final commitment keys.
+template <typename Curve>
+struct AggregationProverKey {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  size_t max_num_proofs() const { return h_alpha_powers.size(); }
+
+  std::vector<G1AffinePoint> g_alpha_powers;
+  std::vector<G1AffinePoint> g_beta_powers;
+  std::vector<G2AffinePoint> h_alpha_powers;
+  std::vector<G2AffinePoint> h_beta_powers;
+};
+
+template <typename Curve>
+struct AggregationVerifierKey {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  G1AffinePoint g;
+  G1AffinePoint g_alpha;
+  G1AffinePoint g_beta;
+  G2AffinePoint h;
+  G2AffinePoint h_alpha;
+  G2AffinePoint h_beta;
+  // The maximum number of proofs the prover key can aggregate. Larger
+  // aggregates are rejected before any work is done on them.
+  size_t max_num_proofs = 0;
+};
+
+// Commitment to a vector under the keys of a and b respectively.
+template <typename Curve>
+struct PairCommitment {
+  using Fp12 = typename Curve::Fp12;
+
+  bool operator==(const PairCommitment& other) const {
+    return t == other.t && u == other.u;
+  }
+  bool operator!=(const PairCommitment& other) const {
+    return !operator==(other);
+  }
+
+  std::string ToString() const { return t.ToString() + "," + u.ToString(); }
+
+  Fp12 t;
+  Fp12 u;
+};
+
+// The cross terms of a round of the inner product arguments. Each round halves
+// the vectors into the left and the right half, and the terms with "_l" are
+// scaled by the challenge x of the round and the ones with "_r" by x⁻¹.
+template <typename Curve>
+struct GIPARound {
+  using Fp12 = typename Curve::Fp12;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+
+  std::string ToString() const {
+    return tab_l.ToString() + "," + tab_r.ToString() + "," +
+           zab_l.ToString() + "," + zab_r.ToString() + "," + tc_l.ToString() +
+           "," + tc_r.ToString() + "," + zc_l.ToString() + "," +
+           zc_r.ToString();
+  }
+
+  PairCommitment<Curve> tab_l;
+  PairCommitment<Curve> tab_r;
+  Fp12 zab_l;
+  Fp12 zab_r;
+  PairCommitment<Curve> tc_l;
+  PairCommitment<Curve> tc_r;
+  G1AffinePoint zc_l;
+  G1AffinePoint zc_r;
+};
+
+// Aggregate of n groth16 proofs (Aᵢ, Bᵢ, Cᵢ) for the same verifying key, as in
+// SnarkPack (https://eprint.iacr.org/2021/529). For a random r, it proves
+//
+//   Z_AB = Π e(Aᵢ, Bᵢ)^(rⁱ) and Z_C = Σ rⁱ·Cᵢ
+//
+// against the commitments to A, B and C with a TIPP and a MIPP argument, which
+// take log n rounds. The verifier then checks the groth16 equation once over
+// Z_AB and Z_C instead of once per proof.
+template <typename Curve>
+struct AggregateProof {
+  using Fp12 = typename Curve::Fp12;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  size_t num_proofs() const { return size_t{1} << rounds.size(); }
+
+  // Returns the size of the proof with the points and the target group
+  // elements uncompressed.
+  size_t GetSizeInBytes() const {
+    using Fq = typename Curve::G1Curve::BaseField;
+    constexpr size_t kFqSize = Fq::kLimbNums * sizeof(uint64_t);
+    constexpr size_t kG1Size = 2 * kFqSize;
+    constexpr size_t kG2Size = 4 * kFqSize;
+    constexpr size_t kFp12Size = 12 * kFqSize;
+
+    // |com_ab|, |com_c| and |ip_ab|, and the tab, zab and tc terms per round.
+    size_t num_fp12s = 5 + 10 * rounds.size();
+    // |agg_c|, the final A, C and w and the openings of w, and the zc terms
+    // per round.
+    size_t num_g1s = 7 + 2 * rounds.size();
+    // The final B and v and the openings of v.
+    size_t num_g2s = 5;
+    return num_fp12s * kFp12Size + num_g1s * kG1Size + num_g2s * kG2Size;
+  }
+
+  PairCommitment<Curve> com_ab;
+  PairCommitment<Curve> com_c;
+  Fp12 ip_ab;
+  G1AffinePoint agg_c;
+  std::vector<GIPARound<Curve>> rounds;
+
+  G1AffinePoint final_a;
+  G2AffinePoint final_b;
+  G1AffinePoint final_c;
+  G2AffinePoint final_v1;
+  G2AffinePoint final_v2;
+  G1AffinePoint final_w1;
+  G1AffinePoint final_w2;
+
+  // KZG openings of the final keys at the last challenge.
+  G2AffinePoint v1_opening;
+  G2AffinePoint v2_opening;
+  G1AffinePoint w1_opening;
+  G1AffinePoint w2_opening;
+};
+
+// Returns 1, |x|, ..., |x|ⁿ⁻¹.
+template <typename F>
+std::vector<F> ComputePowers(const F& x, size_t n) {
+  std::vector<F> powers(n);
+  F power = F::One();
+  for (size_t i = 0; i < n; ++i) {
+    powers[i] = power;
+    power *= x;
+  }
+  return powers;
+}
+
+// Returns Π e(|g1s[i]|, |g2s[i]|).
+template <typename Curve>
+typename Curve::Fp12 MultiPairing(
+    absl::Span<const typename Curve::G1Curve::AffinePoint> g1s,
+    absl::Span<const typename Curve::G2Curve::AffinePoint> g2s) {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2Prepared = typename Curve::G2Prepared;
+
+  CHECK_EQ(g1s.size(), g2s.size());
+  std::vector<G1AffinePoint> a(g1s.begin(), g1s.end());
+  std::vector<G2Prepared> b = base::CreateVector(
+      g2s.size(), [g2s](size_t i) { return G2Prepared::From(g2s[i]); });
+  return math::Pairing<Curve>(a, b);
+}
+
+// Returns (Π e(aᵢ, v1ᵢ)·e(w1ᵢ, bᵢ), Π e(aᵢ, v2ᵢ)·e(w2ᵢ, bᵢ)).
+template <typename Curve>
+PairCommitment<Curve> CommitPair(
+    absl::Span<const typename Curve::G1Curve::AffinePoint> a,
+    absl::Span<const typename Curve::G2Curve::AffinePoint> b,
+    absl::Span<const typename Curve::G2Curve::AffinePoint> v1,
+    absl::Span<const typename Curve::G2Curve::AffinePoint> v2,
+    absl::Span<const typename Curve::G1Curve::AffinePoint> w1,
+    absl::Span<const typename Curve::G1Curve::AffinePoint> w2) {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  auto commit = [a, b](absl::Span<const G2AffinePoint> v,
+                       absl::Span<const G1AffinePoint> w) {
+    std::vector<G1AffinePoint> g1s(a.begin(), a.end());
+    g1s.insert(g1s.end(), w.begin(), w.end());
+    std::vector<G2AffinePoint> g2s(v.begin(), v.end());
+    g2s.insert(g2s.end(), b.begin(), b.end());
+    return MultiPairing<Curve>(g1s, g2s);
+  };
+  return {commit(v1, w1), commit(v2, w2)};
+}
+
+// Returns (Π e(cᵢ, v1ᵢ), Π e(cᵢ, v2ᵢ)).
+template <typename Curve>
+PairCommitment<Curve> CommitSingle(
+    absl::Span<const typename Curve::G1Curve::AffinePoint> c,
+    absl::Span<const typename Curve::G2Curve::AffinePoint> v1,
+    absl::Span<const typename Curve::G2Curve::AffinePoint> v2) {
+  return {MultiPairing<Curve>(c, v1), MultiPairing<Curve>(c, v2)};
+}
+
+// Returns Σ sᵢ·Pᵢ over the |bases| Pᵢ and the |scalars| sᵢ.
+template <typename Point, typename F>
+Point ComputeMSM(absl::Span<const Point> bases, absl::Span<const F> scalars) {
+  using Bucket = typename math::VariableBaseMSM<Point>::Bucket;
+
+  CHECK_EQ(bases.size(), scalars.size());
+  if (bases.empty()) return Point::Zero();
+  math::VariableBaseMSM<Point> msm;
+  Bucket ret;
+  CHECK(msm.Run(bases, scalars, &ret));
+  return ret.ToAffine();
+}
+
+// Folding a vector of size n = 2ᵏ with the coefficients c₀, ..., cₖ₋₁, i.e.,
+// x ← x_L + cⱼ·x_R in the j-th round, leaves Σ pᵢ·xᵢ, where pᵢ is the
+// coefficient of Xⁱ of
+//
+//   Π (1 + cⱼ·X^(2ᵏ⁻¹⁻ʲ))
+//
+// This returns the coefficients of it.
+template <typename F>
+std::vector<F> ComputeFoldingPolynomial(absl::Span<const F> coefficients) {
+  std::vector<F> poly = {F::One()};
+  poly.reserve(size_t{1} << coefficients.size());
+  for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) {
+    size_t size = poly.size();
+    for (size_t i = 0; i < size; ++i) {
+      poly.push_back(poly[i] * *it);
+    }
+  }
+  return poly;
+}
+
+// Evaluates the polynomial of |ComputeFoldingPolynomial()| at |point| in
+// O(k).
+template <typename F>
+F EvaluateFoldingPolynomial(absl::Span<const F> coefficients,
+                            const F& point) {
+  F ret = F::One();
+  F power = point;
+  for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) {
+    ret *= F::One() + *it * power;
+    power = power.Square();
+  }
+  return ret;
+}
+
+// The keys of B are scaled by r⁻ⁱ, so folding them with the challenges xⱼ is
+// the same as folding the unscaled keys with xⱼ·r^(-2ᵏ⁻¹⁻ʲ). This returns
+// the latter.
+template <typename F>
+std::vector<F> ScaleFoldingCoefficients(absl::Span<const F> challenges,
+                                        const F& r) {
+  std::vector<F> ret(challenges.begin(), challenges.end());
+  F r_inv_power = r.Inverse();
+  for (auto it = ret.rbegin(); it != ret.rend(); ++it) {
+    *it *= r_inv_power;
+    r_inv_power = r_inv_power.Square();
+  }
+  return ret;
+}
+
+// Appends the statement that the proofs are aggregated for, i.e., the
+// |verifying_key| and the |public_inputs| of every proof back to back. They go
+// into the transcript before the batching challenge r is drawn, so that the
+// inputs can't be chosen after r to keep Σ rⁱ·Pᵢ while changing the statement.
+template <typename Curve>
+void AppendStatement(
+    const zk::r1cs::groth16::VerifyingKey<Curve>& verifying_key,
+    size_t num_proofs,
+    absl::Span<const typename Curve::G1Curve::ScalarField> public_inputs,
+    AggregationTranscript<typename Curve::G1Curve::ScalarField>* transcript) {
+  transcript->Append(num_proofs);
+  transcript->Append(verifying_key.alpha_g1());
+  transcript->Append(verifying_key.beta_g2());
+  transcript->Append(verifying_key.gamma_g2());
+  transcript->Append(verifying_key.delta_g2());
+  transcript->Append(verifying_key.l_g1_query().size());
+  for (const auto& point : verifying_key.l_g1_query()) {
+    transcript->Append(point);
+  }
+  transcript->Append(public_inputs.size());
+  for (const auto& input : public_inputs) {
+    transcript->Append(input);
+  }
+}
+
+// Appends the values that the last challenge, i.e., the point the final keys
+// are opened at, depends on.
+template <typename Curve>
+void AppendFinalValues(
+    const AggregateProof<Curve>& proof,
+    AggregationTranscript<typename Curve::G1Curve::ScalarField>* transcript) {
+  transcript->Append(proof.final_a);
+  transcript->Append(proof.final_b);
+  transcript->Append(proof.final_c);
+  transcript->Append(proof.final_v1);
+  transcript->Append(proof.final_v2);
+  transcript->Append(proof.final_w1);
+  transcript->Append(proof.final_w2);
+}
+
+// Creates the keys to aggregate up to |max_num_proofs| proofs from random
+// secrets. Whoever knows the secrets can forge aggregates, so this is only
+// fit for tests and benchmarks. In production, the keys should come from two
+// powers-of-tau ceremonies.
+template <typename Curve>
+void CreateAggregationKeysForTesting(
+    size_t max_num_proofs, AggregationProverKey<Curve>* prover_key,
+    AggregationVerifierKey<Curve>* verifier_key) {
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  // The verifier key holds the first powers, gᵃ and hᵃ.
+  CHECK_GE(max_num_proofs, size_t{2});
+  F alpha = F::Random();
+  F beta = F::Random();
+  G1AffinePoint g = G1AffinePoint::Generator();
+  G2AffinePoint h = G2AffinePoint::Generator();
+
+  std::vector<F> alpha_powers = ComputePowers(alpha, 2 * max_num_proofs);
+  std::vector<F> beta_powers = ComputePowers(beta, 2 * max_num_proofs);
+  prover_key->g_alpha_powers.resize(2 * max_num_proofs);
+  prover_key->g_beta_powers.resize(2 * max_num_proofs);
+  prover_key->h_alpha_powers.resize(max_num_proofs);
+  prover_key->h_beta_powers.resize(max_num_proofs);
+  OPENMP_PARALLEL_FOR(size_t i = 0; i < 2 * max_num_proofs; ++i) {
+    prover_key->g_alpha_powers[i] = (g * alpha_powers[i]).ToAffine();
+    prover_key->g_beta_powers[i] = (g * beta_powers[i]).ToAffine();
+    if (i < max_num_proofs) {
+      prover_key->h_alpha_powers[i] = (h * alpha_powers[i]).ToAffine();
+      prover_key->h_beta_powers[i] = (h * beta_powers[i]).ToAffine();
+    }
+  }
+
+  verifier_key->g = g;
+  verifier_key->g_alpha = prover_key->g_alpha_powers[1];
+  verifier_key->g_beta = prover_key->g_beta_powers[1];
+  verifier_key->h = h;
+  verifier_key->h_alpha = prover_key->h_alpha_powers[1];
+  verifier_key->h_beta = prover_key->h_beta_powers[1];
+  verifier_key->max_num_proofs = max_num_proofs;
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_AGGREGATE_PROOF_H_
@@ -0,0 +1,227 @@
+#ifndef SRC_COMMON_AGGREGATE_VERIFIER_H_
+#define SRC_COMMON_AGGREGATE_VERIFIER_H_
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/aggregate_proof.h"
+#include "src/common/aggregation_transcript.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+// Verifies an |AggregateProof<Curve>| made by |ProofAggregator<Curve>|. The
+// inner product arguments are replayed in O(log n) target group
+// exponentiations, and the groth16 equation is checked once for all proofs:
+//
+//   Z_AB = e(α, β)^(Σ rⁱ)·e(Σ rⁱ·Pᵢ, γ)·e(Z_C, δ)
+//
+// where Pᵢ = IC₀ + Σ xᵢⱼ·ICⱼ₊₁ over the public inputs xᵢⱼ of the i-th proof.
+template <typename Curve>
+class AggregateVerifier {
+ public:
+  using F = typename Curve::G1Curve::ScalarField;
+  using Fp12 = typename Curve::Fp12;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G1JacobianPoint = typename Curve::G1Curve::JacobianPoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  AggregateVerifier(const AggregationVerifierKey<Curve>* key,
+                    const zk::r1cs::groth16::VerifyingKey<Curve>* verifying_key)
+      : key_(key),
+        verifying_key_(verifying_key),
+        alpha_beta_(MultiPairing<Curve>(
+            absl::MakeConstSpan(&verifying_key->alpha_g1(), 1),
+            absl::MakeConstSpan(&verifying_key->beta_g2(), 1))) {}
+
+  size_t num_public_inputs() const {
+    return verifying_key_->l_g1_query().size() - 1;
+  }
+
+  // |public_inputs| holds the public inputs of every proof back to back, in
+  // the order the proofs were aggregated.
+  [[nodiscard]] bool Verify(const AggregateProof<Curve>& proof,
+                            absl::Span<const F> public_inputs) const {
+    // Bounded before |num_proofs()|, which would overflow on 64 or more
+    // rounds.
+    if (proof.rounds.empty()) {
+      LOG(ERROR) << "An aggregate proof should have at least one round";
+      return false;
+    }
+    if (proof.rounds.size() >= 8 * sizeof(size_t) ||
+        proof.num_proofs() > key_->max_num_proofs) {
+      LOG(ERROR) << "An aggregate proof should have at most "
+                 << key_->max_num_proofs << " proofs, but got "
+                 << proof.rounds.size() << " rounds";
+      return false;
+    }
+    size_t n = proof.num_proofs();
+    if (public_inputs.size() != n * num_public_inputs()) {
+      LOG(ERROR) << "The number of public inputs is expected to be "
+                 << n * num_public_inputs() << ", but got "
+                 << public_inputs.size();
+      return false;
+    }
+
+    AggregationTranscript<F> transcript(kAggregationTranscriptLabel);
+    AppendStatement(*verifying_key_, n, public_inputs, &transcript);
+    transcript.Append(proof.com_ab);
+    transcript.Append(proof.com_c);
+    F r = transcript.Challenge();
+    transcript.Append(proof.ip_ab);
+    transcript.Append(proof.agg_c);
+
+    PairCommitment<Curve> com_ab = proof.com_ab;
+    PairCommitment<Curve> com_c = proof.com_c;
+    Fp12 ip_ab = proof.ip_ab;
+    G1JacobianPoint agg_c = proof.agg_c.ToJacobian();
+    std::vector<F> challenges;
+    std::vector<F> challenge_invs;
+    for (const GIPARound<Curve>& round : proof.rounds) {
+      transcript.Append(round);
+      F x = transcript.Challenge();
+      F x_inv = x.Inverse();
+      Fold(&com_ab.t, round.tab_l.t, round.tab_r.t, x, x_inv);
+      Fold(&com_ab.u, round.tab_l.u, round.tab_r.u, x, x_inv);
+      Fold(&com_c.t, round.tc_l.t, round.tc_r.t, x, x_inv);
+      Fold(&com_c.u, round.tc_l.u, round.tc_r.u, x, x_inv);
+      Fold(&ip_ab, round.zab_l, round.zab_r, x, x_inv);
+      agg_c = agg_c + round.zc_l * x + round.zc_r * x_inv;
+      challenges.push_back(std::move(x));
+      challenge_invs.push_back(std::move(x_inv));
+    }
+    AppendFinalValues(proof, &transcript);
+    F z = transcript.Challenge();
+
+    // The folded commitments and inner products should match the final
+    // values.
+    absl::Span<const G1AffinePoint> final_a =
+        absl::MakeConstSpan(&proof.final_a, 1);
+    absl::Span<const G2AffinePoint> final_b =
+        absl::MakeConstSpan(&proof.final_b, 1);
+    absl::Span<const G1AffinePoint> final_c =
+        absl::MakeConstSpan(&proof.final_c, 1);
+    absl::Span<const G2AffinePoint> final_v1 =
+        absl::MakeConstSpan(&proof.final_v1, 1);
+    absl::Span<const G2AffinePoint> final_v2 =
+        absl::MakeConstSpan(&proof.final_v2, 1);
+    absl::Span<const G1AffinePoint> final_w1 =
+        absl::MakeConstSpan(&proof.final_w1, 1);
+    absl::Span<const G1AffinePoint> final_w2 =
+        absl::MakeConstSpan(&proof.final_w2, 1);
+    if (com_ab != CommitPair<Curve>(final_a, final_b, final_v1, final_v2,
+                                    final_w1, final_w2)) {
+      return false;
+    }
+    if (ip_ab != MultiPairing<Curve>(final_a, final_b)) return false;
+    if (com_c != CommitSingle<Curve>(final_c, final_v1, final_v2)) {
+      return false;
+    }
+    // The scalars rⁱ fold the same way as the keys of A and C.
+    F s = EvaluateFoldingPolynomial<F>(challenge_invs, r);
+    if (agg_c != proof.final_c * s) return false;
+
+    // The final keys should be the folded commitment keys.
+    F v_eval = EvaluateFoldingPolynomial<F>(challenge_invs, z);
+    if (!VerifyG2Opening(proof.final_v1, v_eval, z, key_->g_alpha,
+                         proof.v1_opening) ||
+        !VerifyG2Opening(proof.final_v2, v_eval, z, key_->g_beta,
+                         proof.v2_opening)) {
+      return false;
+    }
+    F z_pow_n = z;
+    for (size_t i = 0; i < proof.rounds.size(); ++i) {
+      z_pow_n = z_pow_n.Square();
+    }
+    F w_eval = z_pow_n * EvaluateFoldingPolynomial<F>(
+                             ScaleFoldingCoefficients<F>(challenges, r), z);
+    if (!VerifyG1Opening(proof.final_w1, w_eval, z, key_->h_alpha,
+                         proof.w1_opening) ||
+        !VerifyG1Opening(proof.final_w2, w_eval, z, key_->h_beta,
+                         proof.w2_opening)) {
+      return false;
+    }
+
+    return VerifyGroth16(proof, r, public_inputs);
+  }
+
+ private:
+  // |value| ← |value|·|left|ˣ·|right|ˣ⁻¹
+  static void Fold(Fp12* value, const Fp12& left, const Fp12& right,
+                   const F& x, const F& x_inv) {
+    *value *= left.Pow(x.ToBigInt());
+    *value *= right.Pow(x_inv.ToBigInt());
+  }
+
+  // Checks that |commitment| = h^f(s) given f(|z|) = |eval| and the opening
+  // h^q(s), where q(X) = (f(X) - f(|z|)) / (X - |z|) and |g_secret| = gˢ:
+  //
+  //   e(g, |commitment| - |eval|·h)·e(|z|·g - gˢ, |opening|) = 1
+  bool VerifyG2Opening(const G2AffinePoint& commitment, const F& eval,
+                       const F& z, const G1AffinePoint& g_secret,
+                       const G2AffinePoint& opening) const {
+    G1AffinePoint g1s[] = {key_->g,
+                           (key_->g * z - g_secret.ToJacobian()).ToAffine()};
+    G2AffinePoint g2s[] = {(key_->h * (-eval) + commitment).ToAffine(),
+                           opening};
+    return MultiPairing<Curve>(g1s, g2s) == Fp12::One();
+  }
+
+  // Same as above, but for |commitment| = g^f(s) and |h_secret| = hˢ:
+  //
+  //   e(|commitment| - |eval|·g, h)·e(|opening|, |z|·h - hˢ) = 1
+  bool VerifyG1Opening(const G1AffinePoint& commitment, const F& eval,
+                       const F& z, const G2AffinePoint& h_secret,
+                       const G1AffinePoint& opening) const {
+    G1AffinePoint g1s[] = {(key_->g * (-eval) + commitment).ToAffine(),
+                           opening};
+    G2AffinePoint g2s[] = {key_->h,
+                           (key_->h * z - h_secret.ToJacobian()).ToAffine()};
+    return MultiPairing<Curve>(g1s, g2s) == Fp12::One();
+  }
+
+  bool VerifyGroth16(const AggregateProof<Curve>& proof, const F& r,
+                     absl::Span<const F> public_inputs) const {
+    size_t n = proof.num_proofs();
+    size_t num_inputs = num_public_inputs();
+    std::vector<F> r_powers = ComputePowers(r, n);
+
+    // Σ rⁱ·Pᵢ = (Σ rⁱ)·IC₀ + Σⱼ (Σᵢ rⁱ·xᵢⱼ)·ICⱼ₊₁
+    std::vector<F> scalars(num_inputs + 1, F::Zero());
+    for (size_t i = 0; i < n; ++i) {
+      scalars[0] += r_powers[i];
+    }
+    OPENMP_PARALLEL_FOR(size_t j = 0; j < num_inputs; ++j) {
+      for (size_t i = 0; i < n; ++i) {
+        scalars[j + 1] += r_powers[i] * public_inputs[i * num_inputs + j];
+      }
+    }
+    G1AffinePoint prepared_inputs = ComputeMSM<G1AffinePoint>(
+        absl::MakeConstSpan(verifying_key_->l_g1_query()),
+        absl::MakeConstSpan(scalars));
+
+    G1AffinePoint g1s[] = {prepared_inputs, proof.agg_c};
+    G2AffinePoint g2s[] = {verifying_key_->gamma_g2(),
+                           verifying_key_->delta_g2()};
+    Fp12 expected = alpha_beta_.Pow(scalars[0].ToBigInt()) *
+                    MultiPairing<Curve>(g1s, g2s);
+    return proof.ip_ab == expected;
+  }
+
+  // not owned
+  const AggregationVerifierKey<Curve>* key_;
+  // not owned
+  const zk::r1cs::groth16::VerifyingKey<Curve>* verifying_key_;
+  // e(α, β)
+  Fp12 alpha_beta_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_AGGREGATE_VERIFIER_H_
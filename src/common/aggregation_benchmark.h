@@ -0,0 +1,108 @@
+#ifndef SRC_COMMON_AGGREGATION_BENCHMARK_H_
+#define SRC_COMMON_AGGREGATION_BENCHMARK_H_
+
+#include <stddef.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/aggregate_proof.h"
+#include "src/common/aggregate_verifier.h"
+#include "src/common/proof_aggregator.h"
+#include "src/common/rerandomize.h"
+#include "tachyon/base/containers/container_util.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/zk/r1cs/groth16/prepared_verifying_key.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/verify.h"
+
+namespace tachyon::circom {
+
+// Aggregates n = 2, 4, ..., |max_num_proofs| proofs of the same statement and
+// prints the aggregation time, the aggregate size and the verification time
+// against verifying the n proofs one by one. The proofs are re-randomized from
+// |proof|, so that they are distinct without running the prover n times.
+template <typename Curve>
+void RunAggregationBenchmark(
+    const zk::r1cs::groth16::PreparedVerifyingKey<Curve>& prepared_vk,
+    const zk::r1cs::groth16::Proof<Curve>& proof,
+    absl::Span<const typename Curve::G1Curve::ScalarField> public_inputs,
+    size_t max_num_proofs) {
+  using F = typename Curve::G1Curve::ScalarField;
+
+  const auto& verifying_key = prepared_vk.verifying_key();
+
+  auto setup_start_time = std::chrono::high_resolution_clock::now();
+  AggregationProverKey<Curve> prover_key;
+  AggregationVerifierKey<Curve> verifier_key;
+  CreateAggregationKeysForTesting(max_num_proofs, &prover_key, &verifier_key);
+  auto setup_end_time = std::chrono::high_resolution_clock::now();
+  auto setup_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      setup_end_time - setup_start_time);
+
+  std::cout << "Aggregation setup time: " << setup_duration.count()
+            << " milliseconds" << std::endl;
+
+  ProofAggregator<Curve> aggregator(&prover_key, &verifying_key);
+  AggregateVerifier<Curve> verifier(&verifier_key, &verifying_key);
+  for (size_t n = 2; n <= max_num_proofs; n *= 2) {
+    std::vector<zk::r1cs::groth16::Proof<Curve>> proofs = base::CreateVector(
+        n, [&verifying_key, &proof](size_t) {
+          return RerandomizeProof(verifying_key, proof);
+        });
+    std::vector<F> aggregated_inputs;
+    aggregated_inputs.reserve(n * public_inputs.size());
+    for (size_t i = 0; i < n; ++i) {
+      aggregated_inputs.insert(aggregated_inputs.end(), public_inputs.begin(),
+                               public_inputs.end());
+    }
+
+    auto aggregate_start_time = std::chrono::high_resolution_clock::now();
+    AggregateProof<Curve> aggregate_proof =
+        aggregator.Aggregate(absl::MakeConstSpan(proofs),
+                             absl::MakeConstSpan(aggregated_inputs));
+    auto aggregate_end_time = std::chrono::high_resolution_clock::now();
+    auto aggregate_duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            aggregate_end_time - aggregate_start_time);
+
+    auto verify_start_time = std::chrono::high_resolution_clock::now();
+    CHECK(verifier.Verify(aggregate_proof,
+                          absl::MakeConstSpan(aggregated_inputs)));
+    auto verify_end_time = std::chrono::high_resolution_clock::now();
+    auto verify_duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            verify_end_time - verify_start_time);
+
+    // Changing any input changes the statement, which should be rejected.
+    if (!aggregated_inputs.empty()) {
+      aggregated_inputs.back() += F::One();
+      CHECK(!verifier.Verify(aggregate_proof,
+                             absl::MakeConstSpan(aggregated_inputs)));
+    }
+
+    auto batch_verify_start_time = std::chrono::high_resolution_clock::now();
+    for (const zk::r1cs::groth16::Proof<Curve>& p : proofs) {
+      CHECK(zk::r1cs::groth16::VerifyProof(prepared_vk, p, public_inputs));
+    }
+    auto batch_verify_end_time = std::chrono::high_resolution_clock::now();
+    auto batch_verify_duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            batch_verify_end_time - batch_verify_start_time);
+
+    std::cout << "Aggregate " << n
+              << " proofs time: " << aggregate_duration.count()
+              << " milliseconds, size: " << aggregate_proof.GetSizeInBytes()
+              << " bytes, verify time: " << verify_duration.count()
+              << " milliseconds (one by one: "
+              << batch_verify_duration.count() << " milliseconds)"
+              << std::endl;
+  }
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_AGGREGATION_BENCHMARK_H_
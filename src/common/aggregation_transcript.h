@@ -0,0 +1,69 @@
+#ifndef SRC_COMMON_AGGREGATION_TRANSCRIPT_H_
+#define SRC_COMMON_AGGREGATION_TRANSCRIPT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <string_view>
+
+#include "openssl/sha.h"
+
+#include "tachyon/math/base/big_int.h"
+
+namespace tachyon::circom {
+
+// Fiat-Shamir transcript of the proof aggregation. Everything appended since
+// the last challenge is hashed together with the previous state by SHA-256,
+// so each challenge binds all the messages before it.
+//
+// Values are appended by their |ToString()|, which is canonical for reduced
+// field elements and affine points.
+template <typename F>
+class AggregationTranscript {
+ public:
+  static_assert(F::kLimbNums * sizeof(uint64_t) == SHA256_DIGEST_LENGTH,
+                "A digest should fill the limbs of the scalar field");
+
+  explicit AggregationTranscript(std::string_view label) : pending_(label) {}
+
+  void Append(size_t value) {
+    pending_ += std::to_string(value);
+    pending_ += '|';
+  }
+
+  template <typename T>
+  void Append(const T& value) {
+    pending_ += value.ToString();
+    pending_ += '|';
+  }
+
+  // Returns a nonzero challenge, so that it can always be inverted.
+  F Challenge() {
+    while (true) {
+      SHA256_CTX ctx;
+      SHA256_Init(&ctx);
+      SHA256_Update(&ctx, state_, sizeof(state_));
+      SHA256_Update(&ctx, pending_.data(), pending_.size());
+      SHA256_Final(state_, &ctx);
+      pending_.clear();
+
+      math::BigInt<F::kLimbNums> big_int;
+      memcpy(big_int.limbs, state_, sizeof(state_));
+      // Keeping 253 bits puts it below the modulus of the 254 and 255-bit
+      // scalar fields of the pairing friendly curves.
+      big_int.limbs[F::kLimbNums - 1] &= (uint64_t{1} << 61) - 1;
+      F challenge = F::FromBigInt(big_int);
+      if (!challenge.IsZero()) return challenge;
+    }
+  }
+
+ private:
+  uint8_t state_[SHA256_DIGEST_LENGTH] = {0};
+  std::string pending_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_AGGREGATION_TRANSCRIPT_H_
@@ -0,0 +1,184 @@
+#ifndef SRC_COMMON_BATCH_PROVER_H_
+#define SRC_COMMON_BATCH_PROVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "circomlib/circuit/quadratic_arithmetic_program.h"
+#include "circomlib/circuit/witness_loader.h"
+#include "src/common/witness_map.h"
+#include "tachyon/base/containers/container_util.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/zk/r1cs/constraint_system/constraint_matrices.h"
+#include "tachyon/zk/r1cs/groth16/prepared_verifying_key.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/prove.h"
+#include "tachyon/zk/r1cs/groth16/proving_key.h"
+#include "tachyon/zk/r1cs/groth16/verify.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+// Proves many independent witnesses of the same tiny circuit at once. For
+// circuits like adder or multiplier, the fixed cost of a proof, i.e., creating
+// the domain and its coset generator, dominates the proving time. This creates
+// them once for the whole batch and runs one whole proof per thread instead of
+// parallelizing inside a single proof, where there is too little work to
+// split. Each proof still runs its own witness map and MSMs, so the only gain
+// is from the threads and the shared domain; nothing is vectorized across
+// proofs.
+template <typename Curve, typename Domain>
+class BatchProver {
+ public:
+  using F = typename Curve::G1Curve::ScalarField;
+
+  BatchProver(const zk::r1cs::groth16::ProvingKey<Curve>* proving_key,
+              const zk::r1cs::ConstraintMatrices<F>* constraint_matrices)
+      : proving_key_(proving_key),
+        constraint_matrices_(constraint_matrices),
+        domain_(Domain::Create(constraint_matrices->num_constraints +
+                               constraint_matrices->num_instance_variables)),
+        root_of_unity_(WitnessMap<F>::GetCosetGenerator(domain_.get())) {}
+
+  size_t num_variables() const {
+    return constraint_matrices_->num_instance_variables +
+           constraint_matrices_->num_witness_variables;
+  }
+
+  // |full_assignments| holds the full assignments of every proof back to back.
+  std::vector<zk::r1cs::groth16::Proof<Curve>> CreateProofsZK(
+      absl::Span<const F> full_assignments) {
+    CHECK_EQ(full_assignments.size() % num_variables(), size_t{0});
+    size_t batch_size = full_assignments.size() / num_variables();
+
+    std::vector<zk::r1cs::groth16::Proof<Curve>> proofs(batch_size);
+    // Draw the blinding factors up front, so the random generator isn't
+    // shared between threads.
+    std::vector<F> rs =
+        base::CreateVector(batch_size, []() { return F::Random(); });
+    std::vector<F> ss =
+        base::CreateVector(batch_size, []() { return F::Random(); });
+
+    size_t num_instance_variables =
+        constraint_matrices_->num_instance_variables;
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < batch_size; ++i) {
+      absl::Span<const F> z =
+          full_assignments.subspan(i * num_variables(), num_variables());
+      std::vector<F> a;
+      std::vector<F> b;
+      WitnessMap<F>::EvaluateConstraints(domain_.get(), *constraint_matrices_,
+                                         z, &a, &b);
+      std::vector<F> h_evals = WitnessMap<F>::ComputeHEvals(
+          domain_.get(), std::move(a), std::move(b), root_of_unity_);
+      proofs[i] = zk::r1cs::groth16::CreateProofWithAssignment(
+          *proving_key_, rs[i], ss[i], absl::MakeConstSpan(h_evals),
+          z.subspan(1, num_instance_variables - 1),
+          z.subspan(num_instance_variables), z.subspan(1));
+    }
+    return proofs;
+  }
+
+ private:
+  // not owned
+  const zk::r1cs::groth16::ProvingKey<Curve>* proving_key_;
+  // not owned
+  const zk::r1cs::ConstraintMatrices<F>* constraint_matrices_;
+  std::unique_ptr<Domain> domain_;
+  F root_of_unity_;
+};
+
+// Prints the proving time and the throughput of |batch_size| proofs.
+inline void PrintBatchThroughput(std::string_view name, size_t batch_size,
+                                 std::chrono::microseconds duration) {
+  std::cout << name << " prove time: " << duration.count()
+            << " microseconds for " << batch_size << " proofs ("
+            << batch_size * 1e6 / std::max<int64_t>(duration.count(), 1)
+            << " proofs/sec)" << std::endl;
+}
+
+// Proves |batch_size| witnesses with |BatchProver<Curve, Domain>| and then
+// the same witnesses one at a time the way a single proof is made, printing
+// the throughput of both, and checks that every proof verifies.
+// |set_inputs| is called with |witness_loader| to set the inputs of each
+// batch entry before the witness is calculated.
+template <typename Curve, typename Domain, typename SetInputs>
+void RunBatchBenchmark(
+    const zk::r1cs::groth16::ProvingKey<Curve>& proving_key,
+    const zk::r1cs::ConstraintMatrices<typename Curve::G1Curve::ScalarField>&
+        constraint_matrices,
+    WitnessLoader<typename Curve::G1Curve::ScalarField>* witness_loader,
+    size_t batch_size, SetInputs set_inputs) {
+  using F = typename Curve::G1Curve::ScalarField;
+
+  BatchProver<Curve, Domain> batch_prover(&proving_key, &constraint_matrices);
+  size_t num_variables = batch_prover.num_variables();
+  size_t num_instance_variables = constraint_matrices.num_instance_variables;
+
+  std::vector<F> batch_assignments;
+  batch_assignments.reserve(batch_size * num_variables);
+  for (size_t i = 0; i < batch_size; ++i) {
+    set_inputs(witness_loader);
+    witness_loader->Load();
+    for (size_t j = 0; j < num_variables; ++j) {
+      batch_assignments.push_back(witness_loader->Get(j));
+    }
+  }
+  absl::Span<const F> assignments = absl::MakeConstSpan(batch_assignments);
+
+  auto batch_start_time = std::chrono::high_resolution_clock::now();
+  std::vector<zk::r1cs::groth16::Proof<Curve>> batch_proofs =
+      batch_prover.CreateProofsZK(assignments);
+  auto batch_end_time = std::chrono::high_resolution_clock::now();
+  PrintBatchThroughput("Batch", batch_size,
+                       std::chrono::duration_cast<std::chrono::microseconds>(
+                           batch_end_time - batch_start_time));
+
+  auto single_start_time = std::chrono::high_resolution_clock::now();
+  std::vector<zk::r1cs::groth16::Proof<Curve>> single_proofs =
+      base::CreateVector(batch_size, [&](size_t i) {
+        absl::Span<const F> z =
+            assignments.subspan(i * num_variables, num_variables);
+        std::unique_ptr<Domain> domain =
+            Domain::Create(constraint_matrices.num_constraints +
+                           num_instance_variables);
+        std::vector<F> h_evals =
+            QuadraticArithmeticProgram<F>::WitnessMapFromMatrices(
+                domain.get(), constraint_matrices, z);
+        return zk::r1cs::groth16::CreateProofWithAssignmentZK(
+            proving_key, absl::MakeConstSpan(h_evals),
+            z.subspan(1, num_instance_variables - 1),
+            z.subspan(num_instance_variables), z.subspan(1));
+      });
+  auto single_end_time = std::chrono::high_resolution_clock::now();
+  PrintBatchThroughput("One at a time", batch_size,
+                       std::chrono::duration_cast<std::chrono::microseconds>(
+                           single_end_time - single_start_time));
+
+  zk::r1cs::groth16::VerifyingKey<Curve> verifying_key =
+      proving_key.verifying_key();
+  zk::r1cs::groth16::PreparedVerifyingKey<Curve> prepared_verifying_key =
+      std::move(verifying_key).ToPreparedVerifyingKey();
+  for (size_t i = 0; i < batch_size; ++i) {
+    absl::Span<const F> public_inputs =
+        assignments.subspan(i * num_variables + 1, num_instance_variables - 1);
+    CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key,
+                                         batch_proofs[i], public_inputs));
+    CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key,
+                                         single_proofs[i], public_inputs));
+  }
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_BATCH_PROVER_H_
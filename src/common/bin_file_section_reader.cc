@@ -0,0 +1,68 @@
+#include "src/common/bin_file_section_reader.h"
+
+#include <string.h>
+
+#include "tachyon/base/logging.h"
+
+namespace tachyon::circom {
+
+bool BinFileSectionReader::Open(const base::FilePath& path,
+                                std::string_view magic) {
+  magic_ = std::string(magic);
+  file_.open(path.value(), std::ios::binary);
+  if (!file_.is_open()) {
+    LOG(ERROR) << "Failed to open " << path.value();
+    return false;
+  }
+
+  char file_magic[4];
+  uint32_t version;
+  uint32_t num_sections;
+  if (!Read(file_magic, sizeof(file_magic))) return false;
+  if (magic.size() != sizeof(file_magic) ||
+      memcmp(file_magic, magic.data(), sizeof(file_magic)) != 0) {
+    LOG(ERROR) << path.value() << " is not a " << magic_ << " file";
+    return false;
+  }
+  if (!ReadInt(&version)) return false;
+  if (!ReadInt(&num_sections)) return false;
+
+  for (uint32_t i = 0; i < num_sections; ++i) {
+    uint32_t type;
+    uint64_t size;
+    if (!ReadInt(&type)) return false;
+    if (!ReadInt(&size)) return false;
+    uint64_t offset = static_cast<uint64_t>(file_.tellg());
+    sections_[type] = {offset, size};
+    if (!Skip(size)) return false;
+  }
+  return true;
+}
+
+bool BinFileSectionReader::Seek(uint32_t type, uint64_t* size) {
+  auto it = sections_.find(type);
+  if (it == sections_.end()) {
+    LOG(ERROR) << magic_ << " has no section " << type;
+    return false;
+  }
+  file_.clear();
+  file_.seekg(it->second.first);
+  if (size) *size = it->second.second;
+  return file_.good();
+}
+
+bool BinFileSectionReader::Skip(uint64_t size) {
+  file_.seekg(size, std::ios::cur);
+  return file_.good();
+}
+
+bool BinFileSectionReader::Read(void* dst, size_t size) {
+  file_.read(reinterpret_cast<char*>(dst), size);
+  if (static_cast<size_t>(file_.gcount()) != size) {
+    LOG(ERROR) << "Unexpected end of " << magic_ << " file";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace tachyon::circom
@@ -0,0 +1,55 @@
+#ifndef SRC_COMMON_BIN_FILE_SECTION_READER_H_
+#define SRC_COMMON_BIN_FILE_SECTION_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "tachyon/base/files/file_path.h"
+
+namespace tachyon::circom {
+
+// Reads the binary file format shared by the files of circom and snarkjs,
+// e.g., .r1cs and .zkey: a 4-byte magic, a version and a table of sections,
+// each of which is a type id and a size followed by its bytes. Only the
+// section table is kept; every other byte is read on demand.
+class BinFileSectionReader {
+ public:
+  BinFileSectionReader() = default;
+  BinFileSectionReader(const BinFileSectionReader& other) = delete;
+  BinFileSectionReader& operator=(const BinFileSectionReader& other) = delete;
+
+  // Opens |path|, checks that it starts with |magic| and builds the section
+  // table.
+  [[nodiscard]] bool Open(const base::FilePath& path, std::string_view magic);
+
+  // Moves the stream to the beginning of the section |type| and returns its
+  // size in |size| if it is not null.
+  [[nodiscard]] bool Seek(uint32_t type, uint64_t* size = nullptr);
+
+  // Moves the stream |size| bytes forward.
+  [[nodiscard]] bool Skip(uint64_t size);
+
+  [[nodiscard]] bool Read(void* dst, size_t size);
+
+  template <typename T>
+  [[nodiscard]] bool ReadInt(T* value) {
+    return Read(value, sizeof(T));
+  }
+
+ private:
+  std::ifstream file_;
+  // The magic of the file, used in the error messages.
+  std::string magic_;
+  // Maps a section id to its offset and size.
+  std::map<uint32_t, std::pair<uint64_t, uint64_t>> sections_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_BIN_FILE_SECTION_READER_H_
@@ -0,0 +1,23 @@
+#include "src/common/memory_usage.h"
+
+#include <sys/resource.h>
+
+namespace tachyon::circom {
+
+size_t GetPeakRSSInBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+  // On macOS, |ru_maxrss| is reported in bytes.
+  return static_cast<size_t>(usage.ru_maxrss);
+#else
+  // On Linux, |ru_maxrss| is reported in kilobytes.
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+double ToMebibytes(size_t bytes) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+}  // namespace tachyon::circom
@@ -0,0 +1,16 @@
+#ifndef SRC_COMMON_MEMORY_USAGE_H_
+#define SRC_COMMON_MEMORY_USAGE_H_
+
+#include <stddef.h>
+
+namespace tachyon::circom {
+
+// Returns the peak resident set size of the current process in bytes.
+size_t GetPeakRSSInBytes();
+
+// Converts |bytes| to mebibytes for printing.
+double ToMebibytes(size_t bytes);
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_MEMORY_USAGE_H_
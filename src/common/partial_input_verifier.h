@@ -0,0 +1,155 @@
+#ifndef SRC_COMMON_PARTIAL_INPUT_VERIFIER_H_
+#define SRC_COMMON_PARTIAL_INPUT_VERIFIER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "tachyon/base/logging.h"
+#include "tachyon/math/elliptic_curves/msm/variable_base_msm.h"
+#include "tachyon/zk/r1cs/groth16/prepared_verifying_key.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/verify.h"
+
+namespace tachyon::circom {
+
+// Verifies groth16 proofs whose public inputs are partially the same across
+// proofs, e.g., the modulus of the RSA circuit. The fixed inputs are folded
+// into the first IC point once, so only the inputs that vary per proof are
+// left to the MSM of |VerifyProof()|.
+//
+// Optionally, the IC points of the variable inputs are expanded to fixed-base
+// tables, which replaces the per-proof MSM with table lookups and additions at
+// the cost of (2⁸ - 1) * 32 points per input.
+template <typename Curve>
+class PartialInputVerifier {
+ public:
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G1JacobianPoint = typename Curve::G1Curve::JacobianPoint;
+  using PreparedVerifyingKey = zk::r1cs::groth16::PreparedVerifyingKey<Curve>;
+
+  constexpr static size_t kWindowBits = 8;
+  constexpr static size_t kWindowSize = (size_t{1} << kWindowBits) - 1;
+  constexpr static size_t kNumWindows = F::kLimbNums * 64 / kWindowBits;
+
+  // |fixed_inputs[i]| is the i-th public input if it is the same across
+  // proofs, or std::nullopt if it varies per proof.
+  PartialInputVerifier(const PreparedVerifyingKey* prepared_verifying_key,
+                       absl::Span<const std::optional<F>> fixed_inputs,
+                       bool use_fixed_base_tables = false)
+      : prepared_verifying_key_(prepared_verifying_key) {
+    absl::Span<const G1AffinePoint> l_g1_query =
+        prepared_verifying_key->verifying_key().l_g1_query();
+    CHECK_EQ(fixed_inputs.size() + 1, l_g1_query.size());
+
+    std::vector<G1AffinePoint> fixed_bases;
+    std::vector<F> fixed_scalars;
+    for (size_t i = 0; i < fixed_inputs.size(); ++i) {
+      if (fixed_inputs[i].has_value()) {
+        fixed_bases.push_back(l_g1_query[i + 1]);
+        fixed_scalars.push_back(*fixed_inputs[i]);
+      } else {
+        variable_bases_.push_back(l_g1_query[i + 1]);
+      }
+    }
+    folded_ = (l_g1_query[0] + MSM(fixed_bases, fixed_scalars)).ToAffine();
+
+    if (use_fixed_base_tables) {
+      tables_.reserve(variable_bases_.size());
+      for (const G1AffinePoint& base : variable_bases_) {
+        tables_.push_back(BuildTable(base));
+      }
+    }
+  }
+
+  size_t num_variable_inputs() const { return variable_bases_.size(); }
+
+  // |variable_inputs| are the public inputs that were left as std::nullopt,
+  // in the same order.
+  [[nodiscard]] bool Verify(const zk::r1cs::groth16::Proof<Curve>& proof,
+                            absl::Span<const F> variable_inputs) const {
+    if (variable_inputs.size() != variable_bases_.size()) {
+      LOG(ERROR) << "The number of variable inputs is expected to be "
+                 << variable_bases_.size() << ", but got "
+                 << variable_inputs.size();
+      return false;
+    }
+
+    G1JacobianPoint prepared_inputs = folded_.ToJacobian();
+    if (tables_.empty()) {
+      if (!variable_inputs.empty()) {
+        prepared_inputs =
+            prepared_inputs + MSM(variable_bases_, variable_inputs);
+      }
+    } else {
+      for (size_t i = 0; i < variable_inputs.size(); ++i) {
+        prepared_inputs =
+            prepared_inputs + MulWithTable(tables_[i], variable_inputs[i]);
+      }
+    }
+    return zk::r1cs::groth16::VerifyProofWithPreparedInputs(
+        *prepared_verifying_key_, proof, prepared_inputs);
+  }
+
+ private:
+  template <typename BaseContainer, typename ScalarContainer>
+  static G1AffinePoint MSM(const BaseContainer& bases,
+                           const ScalarContainer& scalars) {
+    using Bucket = typename math::VariableBaseMSM<G1AffinePoint>::Bucket;
+
+    if (bases.empty()) return G1AffinePoint::Zero();
+    math::VariableBaseMSM<G1AffinePoint> msm;
+    Bucket ret;
+    CHECK(msm.Run(bases, scalars, &ret));
+    return ret.ToAffine();
+  }
+
+  // |table[j * kWindowSize + k - 1]| = k * 2^(kWindowBits * j) * |base|.
+  static std::vector<G1AffinePoint> BuildTable(const G1AffinePoint& base) {
+    std::vector<G1JacobianPoint> jacobian_table;
+    jacobian_table.reserve(kNumWindows * kWindowSize);
+    G1JacobianPoint window_base = base.ToJacobian();
+    for (size_t j = 0; j < kNumWindows; ++j) {
+      G1JacobianPoint multiple = window_base;
+      for (size_t k = 1; k <= kWindowSize; ++k) {
+        jacobian_table.push_back(multiple);
+        multiple = multiple + window_base;
+      }
+      // |multiple| is now 2^kWindowBits * |window_base|.
+      window_base = multiple;
+    }
+    // Normalized together, so that it takes a single inversion instead of
+    // one per entry.
+    std::vector<G1AffinePoint> table(jacobian_table.size());
+    CHECK(G1JacobianPoint::BatchNormalize(jacobian_table, &table));
+    return table;
+  }
+
+  static G1JacobianPoint MulWithTable(const std::vector<G1AffinePoint>& table,
+                                      const F& scalar) {
+    auto big_int = scalar.ToBigInt();
+    G1JacobianPoint ret = G1JacobianPoint::Zero();
+    for (size_t j = 0; j < kNumWindows; ++j) {
+      size_t bit = j * kWindowBits;
+      size_t k = (big_int[bit / 64] >> (bit % 64)) & kWindowSize;
+      if (k != 0) ret = ret + table[j * kWindowSize + k - 1];
+    }
+    return ret;
+  }
+
+  // not owned
+  const PreparedVerifyingKey* prepared_verifying_key_;
+  // IC₀ + Σ xᵢ·ICᵢ₊₁ over the fixed inputs xᵢ.
+  G1AffinePoint folded_;
+  std::vector<G1AffinePoint> variable_bases_;
+  std::vector<std::vector<G1AffinePoint>> tables_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_PARTIAL_INPUT_VERIFIER_H_
@@ -0,0 +1,175 @@
+#include "src/common/perf_counters.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "src/common/memory_usage.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string.h>
+#endif
+
+namespace tachyon::circom {
+
+namespace {
+
+constexpr std::string_view kPerfCounterNames[] = {
+    "cycles",
+    "instructions",
+    "llc_misses",
+    "dtlb_misses",
+};
+
+#if defined(__linux__)
+int OpenCounter(PerfCounterType type) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  switch (type) {
+    case PerfCounterType::kCycles:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerfCounterType::kInstructions:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerfCounterType::kLLCMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_LL |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case PerfCounterType::kDTLBMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+  }
+  // Counting user space only works under the default perf_event_paranoid.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.inherit = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, /*pid=*/0,
+                                  /*cpu=*/-1, /*group_fd=*/-1, /*flags=*/0));
+}
+#endif
+
+void AppendCounter(std::ostream& os, const std::optional<uint64_t>& value) {
+  if (value.has_value()) {
+    os << *value;
+  } else {
+    os << "null";
+  }
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  for (size_t i = 0; i < kNumPerfCounterTypes; ++i) {
+#if defined(__linux__)
+    fds_[i] = OpenCounter(static_cast<PerfCounterType>(i));
+#else
+    fds_[i] = -1;
+#endif
+  }
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+  for (int fd : fds_) {
+    if (fd >= 0) close(fd);
+  }
+#endif
+}
+
+PerfCounters::Values PerfCounters::Read() const {
+  Values values;
+#if defined(__linux__)
+  for (size_t i = 0; i < kNumPerfCounterTypes; ++i) {
+    if (fds_[i] < 0) continue;
+    // The value, the time enabled and the time running.
+    uint64_t data[3];
+    if (read(fds_[i], data, sizeof(data)) != sizeof(data)) continue;
+    if (data[2] == 0) {
+      values[i] = 0;
+    } else if (data[2] < data[1]) {
+      values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) *
+                                        data[1] / data[2]);
+    } else {
+      values[i] = data[0];
+    }
+  }
+#endif
+  return values;
+}
+
+PhaseProfiler::PhaseProfiler(std::string_view benchmark)
+    : benchmark_(benchmark) {}
+
+void PhaseProfiler::Begin(std::string_view name) {
+  PhaseRecord record;
+  record.name = std::string(name);
+  record.depth = open_phases_.size();
+  records_.push_back(std::move(record));
+  open_phases_.push_back({records_.size() - 1,
+                          std::chrono::steady_clock::now(), counters_.Read()});
+}
+
+void PhaseProfiler::End() {
+  if (open_phases_.empty()) return;
+  PerfCounters::Values end_counters = counters_.Read();
+  auto end_time = std::chrono::steady_clock::now();
+  OpenPhase phase = std::move(open_phases_.back());
+  open_phases_.pop_back();
+
+  PhaseRecord& record = records_[phase.index];
+  record.wall_time_ms =
+      std::chrono::duration<double, std::milli>(end_time - phase.start_time)
+          .count();
+  for (size_t i = 0; i < kNumPerfCounterTypes; ++i) {
+    if (phase.start_counters[i].has_value() && end_counters[i].has_value()) {
+      record.counters[i] = *end_counters[i] - *phase.start_counters[i];
+    }
+  }
+  record.peak_rss_bytes = GetPeakRSSInBytes();
+}
+
+std::string PhaseProfiler::ToJson() const {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\n";
+  os << "  \"benchmark\": \"" << benchmark_ << "\",\n";
+  os << "  \"phases\": [";
+  for (size_t i = 0; i < records_.size(); ++i) {
+    const PhaseRecord& record = records_[i];
+    os << (i == 0 ? "\n" : ",\n");
+    os << "    {\"name\": \"" << record.name << "\", \"depth\": "
+       << record.depth << ", \"wall_time_ms\": " << record.wall_time_ms;
+    for (size_t j = 0; j < kNumPerfCounterTypes; ++j) {
+      os << ", \"" << kPerfCounterNames[j] << "\": ";
+      AppendCounter(os, record.counters[j]);
+    }
+    os << ", \"peak_rss_bytes\": " << record.peak_rss_bytes << "}";
+  }
+  os << "\n  ]\n";
+  os << "}\n";
+  return os.str();
+}
+
+bool PhaseProfiler::WriteJson(const std::string& path) const {
+  std::ofstream file(path);
+  if (!file.is_open()) return false;
+  file << ToJson();
+  return static_cast<bool>(file);
+}
+
+}  // namespace tachyon::circom
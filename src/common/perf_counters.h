@@ -0,0 +1,114 @@
+#ifndef SRC_COMMON_PERF_COUNTERS_H_
+#define SRC_COMMON_PERF_COUNTERS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tachyon::circom {
+
+enum class PerfCounterType {
+  kCycles,
+  kInstructions,
+  kLLCMisses,
+  kDTLBMisses,
+};
+
+constexpr size_t kNumPerfCounterTypes = 4;
+
+// Hardware counters of the whole process, read with Linux perf_event_open().
+// The counters are opened with inherit set, so threads spawned afterwards,
+// e.g., the OpenMP workers, are counted too. A counter the kernel or the CPU
+// refuses, e.g., under a restrictive perf_event_paranoid or in a VM, is left
+// unavailable rather than failing the others. On other platforms, none is
+// available.
+class PerfCounters {
+ public:
+  using Values = std::array<std::optional<uint64_t>, kNumPerfCounterTypes>;
+
+  PerfCounters();
+  PerfCounters(const PerfCounters& other) = delete;
+  PerfCounters& operator=(const PerfCounters& other) = delete;
+  ~PerfCounters();
+
+  // Returns the counts since construction, scaled up if the kernel had to
+  // multiplex the counters.
+  Values Read() const;
+
+ private:
+  std::array<int, kNumPerfCounterTypes> fds_;
+};
+
+struct PhaseRecord {
+  std::string name;
+  // The depth of nesting, 0 for the outermost phases.
+  size_t depth = 0;
+  double wall_time_ms = 0;
+  PerfCounters::Values counters;
+  // The peak resident set size of the process at the end of the phase. It
+  // never goes down, so the phase that raised it is where it first appears.
+  size_t peak_rss_bytes = 0;
+};
+
+// Records the wall time, the hardware counters and the peak RSS of each phase
+// of a benchmark, e.g., zkey load, witness, witness map, each MSM and verify,
+// and writes them as JSON. Phases can be nested, e.g., the MSMs inside prove.
+//
+// Construct it before the first parallel region, so that the counters are
+// inherited by the worker threads.
+class PhaseProfiler {
+ public:
+  explicit PhaseProfiler(std::string_view benchmark);
+
+  void Begin(std::string_view name);
+  void End();
+
+  std::string ToJson() const;
+  [[nodiscard]] bool WriteJson(const std::string& path) const;
+
+ private:
+  struct OpenPhase {
+    size_t index;
+    std::chrono::steady_clock::time_point start_time;
+    PerfCounters::Values start_counters;
+  };
+
+  std::string benchmark_;
+  PerfCounters counters_;
+  std::vector<PhaseRecord> records_;
+  std::vector<OpenPhase> open_phases_;
+};
+
+// Scopes a phase of |profiler|. It does nothing if |profiler| is null, so the
+// phases can be marked unconditionally and profiling stays opt-in.
+class ScopedPhase {
+ public:
+  ScopedPhase(PhaseProfiler* profiler, std::string_view name)
+      : profiler_(profiler) {
+    if (profiler_) profiler_->Begin(name);
+  }
+  ScopedPhase(const ScopedPhase& other) = delete;
+  ScopedPhase& operator=(const ScopedPhase& other) = delete;
+  ~ScopedPhase() { End(); }
+
+  // Ends the phase before the end of the scope, e.g., when the values
+  // computed in the phase are used after it.
+  void End() {
+    if (profiler_) profiler_->End();
+    profiler_ = nullptr;
+  }
+
+ private:
+  // not owned
+  PhaseProfiler* profiler_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_PERF_COUNTERS_H_
@@ -0,0 +1,75 @@
+#ifndef SRC_COMMON_PHASED_PROVE_H_
+#define SRC_COMMON_PHASED_PROVE_H_
+
+#include <stddef.h>
+
+#include <string_view>
+
+#include "absl/types/span.h"
+
+#include "src/common/perf_counters.h"
+#include "src/common/proof_assembly.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/math/elliptic_curves/msm/variable_base_msm.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/proving_key.h"
+
+namespace tachyon::circom {
+
+// Runs Σ sᵢ·Pᵢ over |bases| and |scalars| as the phase |name| of |profiler|.
+template <typename Point, typename F>
+Point PhasedMSM(PhaseProfiler* profiler, std::string_view name,
+                absl::Span<const Point> bases, absl::Span<const F> scalars) {
+  using Bucket = typename math::VariableBaseMSM<Point>::Bucket;
+
+  ScopedPhase phase(profiler, name);
+  CHECK_EQ(bases.size(), scalars.size());
+  if (bases.empty()) return Point::Zero();
+  math::VariableBaseMSM<Point> msm;
+  Bucket ret;
+  CHECK(msm.Run(bases, scalars, &ret));
+  return ret.ToAffine();
+}
+
+// Same as |zk::r1cs::groth16::CreateProofWithAssignmentZK()| for a proving key
+// converted from a circom zkey, but runs each MSM as its own phase of
+// |profiler|, so that they can be told apart in the hardware counters. zᵢ are
+// the |full_assignments|, including the leading one. The proof is assembled by
+// |AssembleProof()|, the same as the streaming prover.
+template <typename Curve>
+zk::r1cs::groth16::Proof<Curve> CreateProofWithPhases(
+    const zk::r1cs::groth16::ProvingKey<Curve>& proving_key,
+    absl::Span<const typename Curve::G1Curve::ScalarField> h_evals,
+    absl::Span<const typename Curve::G1Curve::ScalarField> full_assignments,
+    size_t num_instance_variables, PhaseProfiler* profiler) {
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  ProofMSMs<Curve> msms;
+  msms.a = PhasedMSM<G1AffinePoint>(
+      profiler, "msm_a", absl::MakeConstSpan(proving_key.a_g1_query()),
+      full_assignments);
+  msms.b1 = PhasedMSM<G1AffinePoint>(
+      profiler, "msm_b1", absl::MakeConstSpan(proving_key.b_g1_query()),
+      full_assignments);
+  msms.b2 = PhasedMSM<G2AffinePoint>(
+      profiler, "msm_b2", absl::MakeConstSpan(proving_key.b_g2_query()),
+      full_assignments);
+  msms.c = PhasedMSM<G1AffinePoint>(
+      profiler, "msm_c", absl::MakeConstSpan(proving_key.l_g1_query()),
+      full_assignments.subspan(num_instance_variables));
+  msms.h = PhasedMSM<G1AffinePoint>(
+      profiler, "msm_h", absl::MakeConstSpan(proving_key.h_g1_query()),
+      h_evals);
+
+  const auto& verifying_key = proving_key.verifying_key();
+  return AssembleProof<Curve>(verifying_key.alpha_g1(), proving_key.beta_g1(),
+                              verifying_key.beta_g2(), proving_key.delta_g1(),
+                              verifying_key.delta_g2(), msms, F::Random(),
+                              F::Random());
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_PHASED_PROVE_H_
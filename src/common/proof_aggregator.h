@@ -0,0 +1,211 @@
+#ifndef SRC_COMMON_PROOF_AGGREGATOR_H_
+#define SRC_COMMON_PROOF_AGGREGATOR_H_
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/aggregate_proof.h"
+#include "src/common/aggregation_transcript.h"
+#include "tachyon/base/containers/container_util.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+// Aggregates groth16 proofs for the same verifying key into an
+// |AggregateProof<Curve>| of size O(log n), which |AggregateVerifier<Curve>|
+// checks in O(log n) pairing-group operations plus an MSM over the public
+// inputs, instead of n pairing checks.
+template <typename Curve>
+class ProofAggregator {
+ public:
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  ProofAggregator(const AggregationProverKey<Curve>* key,
+                  const zk::r1cs::groth16::VerifyingKey<Curve>* verifying_key)
+      : key_(key), verifying_key_(verifying_key) {}
+
+  size_t num_public_inputs() const {
+    return verifying_key_->l_g1_query().size() - 1;
+  }
+
+  // The number of |proofs| must be a power of two of at least 2, and at most
+  // |key->max_num_proofs()|. |public_inputs| holds the public inputs of every
+  // proof back to back, in the same order as |proofs|.
+  AggregateProof<Curve> Aggregate(
+      absl::Span<const zk::r1cs::groth16::Proof<Curve>> proofs,
+      absl::Span<const F> public_inputs) const {
+    size_t n = proofs.size();
+    CHECK_GE(n, size_t{2});
+    CHECK_EQ(n & (n - 1), size_t{0}) << "The number of proofs should be a "
+                                        "power of two";
+    CHECK_LE(n, key_->max_num_proofs());
+    CHECK_EQ(public_inputs.size(), n * num_public_inputs());
+
+    std::vector<G1AffinePoint> a =
+        base::CreateVector(n, [proofs](size_t i) { return proofs[i].a(); });
+    std::vector<G2AffinePoint> b =
+        base::CreateVector(n, [proofs](size_t i) { return proofs[i].b(); });
+    std::vector<G1AffinePoint> c =
+        base::CreateVector(n, [proofs](size_t i) { return proofs[i].c(); });
+    std::vector<G2AffinePoint> v1(key_->h_alpha_powers.begin(),
+                                  key_->h_alpha_powers.begin() + n);
+    std::vector<G2AffinePoint> v2(key_->h_beta_powers.begin(),
+                                  key_->h_beta_powers.begin() + n);
+    std::vector<G1AffinePoint> w1(key_->g_alpha_powers.begin() + n,
+                                  key_->g_alpha_powers.begin() + 2 * n);
+    std::vector<G1AffinePoint> w2(key_->g_beta_powers.begin() + n,
+                                  key_->g_beta_powers.begin() + 2 * n);
+
+    AggregateProof<Curve> proof;
+    proof.com_ab = CommitPair<Curve>(a, b, v1, v2, w1, w2);
+    proof.com_c = CommitSingle<Curve>(c, v1, v2);
+
+    AggregationTranscript<F> transcript(kAggregationTranscriptLabel);
+    AppendStatement(*verifying_key_, n, public_inputs, &transcript);
+    transcript.Append(proof.com_ab);
+    transcript.Append(proof.com_c);
+    F r = transcript.Challenge();
+
+    // Bᵢ is scaled by rⁱ and its key wᵢ by r⁻ⁱ, which leaves the commitment
+    // to A and B as it is, while Π e(Aᵢ, rⁱ·Bᵢ) is Z_AB.
+    std::vector<F> r_powers = ComputePowers(r, n);
+    std::vector<F> r_inv_powers = ComputePowers(r.Inverse(), n);
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < n; ++i) {
+      b[i] = (b[i] * r_powers[i]).ToAffine();
+      w1[i] = (w1[i] * r_inv_powers[i]).ToAffine();
+      w2[i] = (w2[i] * r_inv_powers[i]).ToAffine();
+    }
+    proof.ip_ab = MultiPairing<Curve>(a, b);
+    proof.agg_c = ComputeMSM<G1AffinePoint>(absl::MakeConstSpan(c),
+                                            absl::MakeConstSpan(r_powers));
+    transcript.Append(proof.ip_ab);
+    transcript.Append(proof.agg_c);
+
+    // The scalars of the MIPP on C.
+    std::vector<F> s = std::move(r_powers);
+    std::vector<F> challenges;
+    std::vector<F> challenge_invs;
+    while (a.size() > 1) {
+      size_t m = a.size() / 2;
+      auto left = [m](const auto& v) {
+        return absl::MakeConstSpan(v).first(m);
+      };
+      auto right = [m](const auto& v) {
+        return absl::MakeConstSpan(v).last(m);
+      };
+
+      GIPARound<Curve> round;
+      round.tab_l = CommitPair<Curve>(right(a), left(b), left(v1), left(v2),
+                                      right(w1), right(w2));
+      round.tab_r = CommitPair<Curve>(left(a), right(b), right(v1), right(v2),
+                                      left(w1), left(w2));
+      round.zab_l = MultiPairing<Curve>(right(a), left(b));
+      round.zab_r = MultiPairing<Curve>(left(a), right(b));
+      round.tc_l = CommitSingle<Curve>(right(c), left(v1), left(v2));
+      round.tc_r = CommitSingle<Curve>(left(c), right(v1), right(v2));
+      round.zc_l = ComputeMSM<G1AffinePoint>(right(c), left(s));
+      round.zc_r = ComputeMSM<G1AffinePoint>(left(c), right(s));
+      transcript.Append(round);
+      proof.rounds.push_back(std::move(round));
+
+      F x = transcript.Challenge();
+      F x_inv = x.Inverse();
+      Fold(&a, x);
+      Fold(&c, x);
+      Fold(&w1, x);
+      Fold(&w2, x);
+      Fold(&b, x_inv);
+      Fold(&v1, x_inv);
+      Fold(&v2, x_inv);
+      FoldScalars(&s, x_inv);
+      challenges.push_back(std::move(x));
+      challenge_invs.push_back(std::move(x_inv));
+    }
+
+    proof.final_a = a[0];
+    proof.final_b = b[0];
+    proof.final_c = c[0];
+    proof.final_v1 = v1[0];
+    proof.final_v2 = v2[0];
+    proof.final_w1 = w1[0];
+    proof.final_w2 = w2[0];
+    AppendFinalValues(proof, &transcript);
+    F z = transcript.Challenge();
+
+    // v = h^f_v(a), where f_v(X) = Π (1 + xⱼ⁻¹·X^(n/2ʲ⁺¹)).
+    std::vector<F> v_poly = ComputeFoldingPolynomial<F>(challenge_invs);
+    std::vector<F> v_quotient = DivideByLinear(v_poly, z);
+    proof.v1_opening = ComputeMSM<G2AffinePoint>(
+        absl::MakeConstSpan(key_->h_alpha_powers).first(v_quotient.size()),
+        absl::MakeConstSpan(v_quotient));
+    proof.v2_opening = ComputeMSM<G2AffinePoint>(
+        absl::MakeConstSpan(key_->h_beta_powers).first(v_quotient.size()),
+        absl::MakeConstSpan(v_quotient));
+
+    // w = g^f_w(a), where f_w(X) = Xⁿ·Π (1 + xⱼ·r^(-n/2ʲ⁺¹)·X^(n/2ʲ⁺¹)).
+    std::vector<F> scaled_challenges =
+        ScaleFoldingCoefficients<F>(challenges, r);
+    std::vector<F> w_poly(n, F::Zero());
+    std::vector<F> w_tail = ComputeFoldingPolynomial<F>(scaled_challenges);
+    w_poly.insert(w_poly.end(), w_tail.begin(), w_tail.end());
+    std::vector<F> w_quotient = DivideByLinear(w_poly, z);
+    proof.w1_opening = ComputeMSM<G1AffinePoint>(
+        absl::MakeConstSpan(key_->g_alpha_powers).first(w_quotient.size()),
+        absl::MakeConstSpan(w_quotient));
+    proof.w2_opening = ComputeMSM<G1AffinePoint>(
+        absl::MakeConstSpan(key_->g_beta_powers).first(w_quotient.size()),
+        absl::MakeConstSpan(w_quotient));
+    return proof;
+  }
+
+ private:
+  // |points| ← |points_L| + |coefficient|·|points_R|
+  template <typename Point>
+  static void Fold(std::vector<Point>* points, const F& coefficient) {
+    size_t m = points->size() / 2;
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < m; ++i) {
+      (*points)[i] =
+          ((*points)[m + i] * coefficient + (*points)[i]).ToAffine();
+    }
+    points->resize(m);
+  }
+
+  static void FoldScalars(std::vector<F>* scalars, const F& coefficient) {
+    size_t m = scalars->size() / 2;
+    for (size_t i = 0; i < m; ++i) {
+      (*scalars)[i] += (*scalars)[m + i] * coefficient;
+    }
+    scalars->resize(m);
+  }
+
+  // Returns the coefficients of (f(X) - f(|z|)) / (X - |z|) for the
+  // coefficients of f in |poly|.
+  static std::vector<F> DivideByLinear(const std::vector<F>& poly,
+                                       const F& z) {
+    std::vector<F> quotient(poly.size() - 1);
+    F acc = F::Zero();
+    for (size_t i = poly.size() - 1; i > 0; --i) {
+      acc = acc * z + poly[i];
+      quotient[i - 1] = acc;
+    }
+    return quotient;
+  }
+
+  // not owned
+  const AggregationProverKey<Curve>* key_;
+  // not owned
+  const zk::r1cs::groth16::VerifyingKey<Curve>* verifying_key_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_PROOF_AGGREGATOR_H_
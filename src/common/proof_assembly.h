@@ -0,0 +1,58 @@
+#ifndef SRC_COMMON_PROOF_ASSEMBLY_H_
+#define SRC_COMMON_PROOF_ASSEMBLY_H_
+
+#include "tachyon/zk/r1cs/groth16/proof.h"
+
+namespace tachyon::circom {
+
+// The MSMs that a groth16 proof is made of, where zᵢ are the full
+// assignments, wᵢ the witness assignments and hᵢ the evaluations of h.
+template <typename Curve>
+struct ProofMSMs {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  // Σ zᵢ·Aᵢ
+  G1AffinePoint a;
+  // Σ zᵢ·B₁ᵢ
+  G1AffinePoint b1;
+  // Σ zᵢ·B₂ᵢ
+  G2AffinePoint b2;
+  // Σ wᵢ·Cᵢ
+  G1AffinePoint c;
+  // Σ hᵢ·Hᵢ
+  G1AffinePoint h;
+};
+
+// Assembles the proof from |msms| and the blinding factors |r| and |s|.
+//
+//   A  = α₁ + Σ zᵢ·Aᵢ + r·δ₁
+//   B₁ = β₁ + Σ zᵢ·B₁ᵢ + s·δ₁
+//   B  = β₂ + Σ zᵢ·B₂ᵢ + s·δ₂
+//   C  = Σ wᵢ·Cᵢ + Σ hᵢ·Hᵢ + s·A + r·B₁ - rs·δ₁
+template <typename Curve>
+zk::r1cs::groth16::Proof<Curve> AssembleProof(
+    const typename Curve::G1Curve::AffinePoint& alpha_g1,
+    const typename Curve::G1Curve::AffinePoint& beta_g1,
+    const typename Curve::G2Curve::AffinePoint& beta_g2,
+    const typename Curve::G1Curve::AffinePoint& delta_g1,
+    const typename Curve::G2Curve::AffinePoint& delta_g2,
+    const ProofMSMs<Curve>& msms,
+    const typename Curve::G1Curve::ScalarField& r,
+    const typename Curve::G1Curve::ScalarField& s) {
+  using G1JacobianPoint = typename Curve::G1Curve::JacobianPoint;
+  using G2JacobianPoint = typename Curve::G2Curve::JacobianPoint;
+
+  G1JacobianPoint g_a = delta_g1 * r + alpha_g1 + msms.a;
+  G1JacobianPoint g1_b = delta_g1 * s + beta_g1 + msms.b1;
+  G2JacobianPoint g2_b = delta_g2 * s + beta_g2 + msms.b2;
+  G1JacobianPoint g_c =
+      g_a * s + g1_b * r - delta_g1 * (r * s) + msms.c + msms.h;
+
+  return zk::r1cs::groth16::Proof<Curve>(g_a.ToAffine(), g2_b.ToAffine(),
+                                         g_c.ToAffine());
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_PROOF_ASSEMBLY_H_
@@ -0,0 +1,195 @@
+#ifndef SRC_COMMON_R1CS_CHECKER_H_
+#define SRC_COMMON_R1CS_CHECKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/bin_file_section_reader.h"
+#include "src/common/witness_map.h"
+#include "src/common/zkey_section_reader.h"
+#include "tachyon/base/files/file_path.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/math/base/big_int.h"
+#include "tachyon/zk/r1cs/constraint_system/constraint_matrices.h"
+
+namespace tachyon::circom {
+
+// Checks (A·z)ᵢ·(B·z)ᵢ = (C·z)ᵢ for every constraint before proving, so that a
+// wrong witness, e.g., from a bad input or a mismatched .dat or zkey, fails
+// right away instead of at the final |VerifyProof()|.
+//
+// A·z and B·z are taken from the witness map, which computes them anyway.
+// circom zkeys don't carry the C matrix, so it is loaded from the .r1cs file
+// of the circuit instead.
+template <typename F>
+class R1CSChecker {
+ public:
+  constexpr static size_t kDefaultMaxFailures = 10;
+
+  size_t num_constraints() const { return row_offsets_.size() - 1; }
+
+  // Loads the C matrix from the .r1cs file at |path|.
+  [[nodiscard]] bool Load(const base::FilePath& path) {
+    BinFileSectionReader reader;
+    if (!reader.Open(path, "r1cs")) return false;
+
+    // n8, prime, |num_wires|, the number of public outputs, public inputs and
+    // private inputs, the number of labels and the number of constraints.
+    uint32_t field_size;
+    uint32_t num_constraints;
+    if (!reader.Seek(kHeaderSection)) return false;
+    if (!reader.ReadInt(&field_size)) return false;
+    if (field_size != GetFieldByteSize<F>()) {
+      LOG(ERROR) << "r1cs was created for another field";
+      return false;
+    }
+    if (!reader.Skip(field_size)) return false;
+    if (!reader.ReadInt(&num_wires_)) return false;
+    if (!reader.Skip(3 * sizeof(uint32_t) + sizeof(uint64_t))) return false;
+    if (!reader.ReadInt(&num_constraints)) return false;
+
+    if (!reader.Seek(kConstraintsSection)) return false;
+    return ReadCMatrix(&reader, num_constraints);
+  }
+
+  // Returns the indices of at most |max_failures| first constraints that
+  // |a| = A·z, |b| = B·z and |full_assignments| = z don't satisfy. The
+  // constraints are checked in parallel, one contiguous block per thread.
+  std::vector<size_t> FindFailingConstraints(
+      absl::Span<const F> a, absl::Span<const F> b,
+      absl::Span<const F> full_assignments,
+      size_t max_failures = kDefaultMaxFailures) const {
+    CHECK_GE(a.size(), num_constraints());
+    CHECK_GE(b.size(), num_constraints());
+    CHECK_GE(full_assignments.size(), size_t{num_wires_});
+
+    std::vector<uint8_t> failed(num_constraints());
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < num_constraints(); ++i) {
+      F c = F::Zero();
+      for (size_t j = row_offsets_[i]; j < row_offsets_[i + 1]; ++j) {
+        c += terms_[j].coefficient * full_assignments[terms_[j].signal];
+      }
+      failed[i] = a[i] * b[i] != c;
+    }
+
+    std::vector<size_t> failures;
+    for (size_t i = 0; i < failed.size() && failures.size() < max_failures;
+         ++i) {
+      if (failed[i]) failures.push_back(i);
+    }
+    return failures;
+  }
+
+  // Same as |QuadraticArithmeticProgram<F>::WitnessMapFromMatrices()|, but
+  // checks the constraints on the A·z and B·z evaluations in between. If
+  // |release_matrices| is true, the rows of |matrices| are freed right after
+  // A·z and B·z are evaluated, as |WitnessMap<F>::LeanWitnessMapFromMatrices()|
+  // does. Returns std::nullopt after logging the first failing constraints if
+  // the witness doesn't satisfy them.
+  template <typename Domain>
+  std::optional<std::vector<F>> WitnessMapFromMatrices(
+      const Domain* domain, zk::r1cs::ConstraintMatrices<F>* matrices,
+      absl::Span<const F> full_assignments, bool release_matrices) const {
+    if (!CheckSizes(*matrices, full_assignments)) return std::nullopt;
+
+    std::vector<F> a;
+    std::vector<F> b;
+    WitnessMap<F>::EvaluateConstraints(domain, *matrices, full_assignments, &a,
+                                       &b);
+    if (release_matrices) WitnessMap<F>::ReleaseMatrices(matrices);
+    if (!CheckConstraints(a, b, full_assignments)) return std::nullopt;
+    return WitnessMap<F>::ComputeHEvals(domain, std::move(a), std::move(b));
+  }
+
+ private:
+  constexpr static uint32_t kHeaderSection = 1;
+  constexpr static uint32_t kConstraintsSection = 2;
+
+  struct Term {
+    uint32_t signal;
+    F coefficient;
+  };
+
+  bool CheckSizes(const zk::r1cs::ConstraintMatrices<F>& matrices,
+                  absl::Span<const F> full_assignments) const {
+    if (matrices.num_constraints != num_constraints()) {
+      LOG(ERROR) << "The zkey has " << matrices.num_constraints
+                 << " constraints, but the r1cs has " << num_constraints();
+      return false;
+    }
+    if (full_assignments.size() != num_wires_) {
+      LOG(ERROR) << "The witness has " << full_assignments.size()
+                 << " variables, but the r1cs has " << num_wires_ << " wires";
+      return false;
+    }
+    return true;
+  }
+
+  // Logs the first failing constraints, if any.
+  bool CheckConstraints(absl::Span<const F> a, absl::Span<const F> b,
+                        absl::Span<const F> full_assignments) const {
+    std::vector<size_t> failures =
+        FindFailingConstraints(a, b, full_assignments);
+    for (size_t i : failures) {
+      LOG(ERROR) << "Constraint " << i << " is not satisfied";
+    }
+    return failures.empty();
+  }
+
+  // Each constraint is stored as the terms of A, B and C in order, where each
+  // term is a wire id followed by its coefficient in canonical form. A and B
+  // are skipped.
+  bool ReadCMatrix(BinFileSectionReader* reader, uint32_t num_constraints) {
+    constexpr size_t kTermSize = sizeof(uint32_t) + GetFieldByteSize<F>();
+
+    row_offsets_.assign(1, 0);
+    row_offsets_.reserve(num_constraints + 1);
+    terms_.clear();
+    std::vector<uint8_t> buffer;
+    for (uint32_t i = 0; i < num_constraints; ++i) {
+      for (size_t matrix = 0; matrix < 3; ++matrix) {
+        uint32_t num_terms;
+        if (!reader->ReadInt(&num_terms)) return false;
+        if (matrix < 2) {
+          if (!reader->Skip(num_terms * kTermSize)) return false;
+          continue;
+        }
+
+        buffer.resize(num_terms * kTermSize);
+        if (!reader->Read(buffer.data(), buffer.size())) return false;
+        for (uint32_t j = 0; j < num_terms; ++j) {
+          const uint8_t* ptr = &buffer[j * kTermSize];
+          uint32_t signal;
+          memcpy(&signal, ptr, sizeof(signal));
+          if (signal >= num_wires_) {
+            LOG(ERROR) << "Wire " << signal << " of constraint " << i
+                       << " is out of range";
+            return false;
+          }
+          math::BigInt<F::kLimbNums> big_int;
+          memcpy(big_int.limbs, ptr + sizeof(uint32_t), sizeof(big_int.limbs));
+          terms_.push_back({signal, F::FromBigInt(big_int)});
+        }
+      }
+      row_offsets_.push_back(terms_.size());
+    }
+    return true;
+  }
+
+  uint32_t num_wires_ = 0;
+  // The C matrix in compressed sparse row format.
+  std::vector<size_t> row_offsets_ = {0};
+  std::vector<Term> terms_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_R1CS_CHECKER_H_
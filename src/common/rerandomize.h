@@ -0,0 +1,54 @@
+#ifndef SRC_COMMON_RERANDOMIZE_H_
+#define SRC_COMMON_RERANDOMIZE_H_
+
+#include "tachyon/base/logging.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+// Re-randomizes |proof| so that it can't be linked to the original one, while
+// still proving the same statement. Given random r₁ ≠ 0 and r₂, it returns
+//
+//   A' = r₁⁻¹·A
+//   B' = r₁·B + r₁r₂·δ₂
+//   C' = C + r₂·A
+//
+// which satisfies e(A', B') = e(A, B)·e(A, δ₂)ʳ² and
+// e(C', δ₂) = e(C, δ₂)·e(A, δ₂)ʳ², so the verification equation still holds.
+// This only costs 4 scalar multiplications instead of a full prove.
+template <typename Curve>
+zk::r1cs::groth16::Proof<Curve> RerandomizeProof(
+    const zk::r1cs::groth16::VerifyingKey<Curve>& verifying_key,
+    const zk::r1cs::groth16::Proof<Curve>& proof,
+    const typename Curve::G1Curve::ScalarField& r1,
+    const typename Curve::G1Curve::ScalarField& r2) {
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1JacobianPoint = typename Curve::G1Curve::JacobianPoint;
+  using G2JacobianPoint = typename Curve::G2Curve::JacobianPoint;
+
+  CHECK(!r1.IsZero());
+  F r1_inv = r1.Inverse();
+  G1JacobianPoint a = proof.a() * r1_inv;
+  G2JacobianPoint b = proof.b() * r1 + verifying_key.delta_g2() * (r1 * r2);
+  G1JacobianPoint c = proof.a() * r2 + proof.c();
+  return zk::r1cs::groth16::Proof<Curve>(a.ToAffine(), b.ToAffine(),
+                                         c.ToAffine());
+}
+
+template <typename Curve>
+zk::r1cs::groth16::Proof<Curve> RerandomizeProof(
+    const zk::r1cs::groth16::VerifyingKey<Curve>& verifying_key,
+    const zk::r1cs::groth16::Proof<Curve>& proof) {
+  using F = typename Curve::G1Curve::ScalarField;
+
+  F r1 = F::Random();
+  while (r1.IsZero()) {
+    r1 = F::Random();
+  }
+  return RerandomizeProof(verifying_key, proof, r1, F::Random());
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_RERANDOMIZE_H_
@@ -0,0 +1,250 @@
+#ifndef SRC_COMMON_STREAMING_PROVER_H_
+#define SRC_COMMON_STREAMING_PROVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/proof_assembly.h"
+#include "src/common/witness_map.h"
+#include "src/common/zkey_section_reader.h"
+#include "tachyon/base/files/file_path.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/math/base/big_int.h"
+#include "tachyon/math/elliptic_curves/msm/variable_base_msm.h"
+#include "tachyon/zk/r1cs/groth16/proof.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+// Creates groth16 proofs straight from a zkey file while keeping the memory
+// used by the prover under a user-set limit. Instead of holding the whole
+// proving key and constraint matrices, it streams the coefficient section and
+// every point section from disk in chunks, running an MSM per chunk and
+// accumulating the partial sums. This trades the extra disk reads for a
+// predictable peak memory.
+//
+// The limit covers what the prover allocates: the full assignments, the
+// domain-sized witness map buffers, the chunks and an estimate of the scratch
+// memory of |math::VariableBaseMSM| per chunk. Memory owned by the caller,
+// such as the witness calculator, is not counted, so the caller should free it
+// before proving.
+template <typename Curve>
+class StreamingProver {
+ public:
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  constexpr static size_t kG2Size = GetG2ByteSize<G2AffinePoint>();
+  constexpr static size_t kFieldSize = GetFieldByteSize<F>();
+  constexpr static size_t kCoefficientSize = GetCoefficientByteSize<F>();
+  // The scratch memory of |math::VariableBaseMSM| per point, i.e., the scalar
+  // in its big int form and a bucket. The buckets of all windows come to
+  // about one per point once a chunk is large enough for memory to matter.
+  constexpr static size_t kMSMScratchSize =
+      sizeof(math::BigInt<F::kLimbNums>) +
+      sizeof(typename math::VariableBaseMSM<G2AffinePoint>::Bucket);
+  // Below this, the per-chunk MSM overhead dominates the proving time.
+  constexpr static size_t kMinChunkSize = 1 << 10;
+
+  explicit StreamingProver(size_t memory_limit) : memory_limit_(memory_limit) {}
+
+  size_t num_instance_variables() const {
+    return reader_.header().num_public + 1;
+  }
+  size_t num_witness_variables() const {
+    return reader_.header().num_vars - num_instance_variables();
+  }
+  size_t domain_size() const { return reader_.header().domain_size; }
+  size_t chunk_size() const { return chunk_size_; }
+
+  // Opens |zkey_path| and sizes the chunks to fit in the memory limit. Returns
+  // false if the zkey is invalid or the limit can't even hold the
+  // domain-sized buffers.
+  [[nodiscard]] bool Open(const base::FilePath& zkey_path) {
+    if (!reader_.Open(zkey_path)) return false;
+    const ZKeyGroth16Header& header = reader_.header();
+    if (header.base_field_bytes != GetFieldByteSize<typename G1AffinePoint::
+                                                        BaseField>() ||
+        header.scalar_field_bytes != kFieldSize) {
+      LOG(ERROR) << "zkey was created for another curve";
+      return false;
+    }
+
+    // The witness map is the phase that needs the most: the full assignments
+    // and the three domain-sized buffers, a, b and c.
+    size_t fixed_bytes = sizeof(F) * (header.num_vars + 3 * domain_size());
+    // The widest element that is streamed is a G2 point, which is held both
+    // in its raw and its native form while a chunk is converted, and then fed
+    // to the MSM.
+    size_t element_bytes = kG2Size + sizeof(G2AffinePoint) + kMSMScratchSize;
+    if (memory_limit_ <= fixed_bytes ||
+        (memory_limit_ - fixed_bytes) / element_bytes < kMinChunkSize) {
+      LOG(ERROR) << "Memory limit " << memory_limit_
+                 << " bytes is too small, it needs at least "
+                 << fixed_bytes + kMinChunkSize * element_bytes << " bytes";
+      return false;
+    }
+    chunk_size_ = (memory_limit_ - fixed_bytes) / element_bytes;
+    return true;
+  }
+
+  // Reads the verifying key, which is small enough to be loaded at once.
+  std::optional<zk::r1cs::groth16::VerifyingKey<Curve>> ReadVerifyingKey() {
+    std::optional<ZKeyGroth16Points<Curve>> points =
+        ReadGroth16Points<Curve>(&reader_);
+    if (!points) return std::nullopt;
+
+    std::vector<G1AffinePoint> l_g1_query(num_instance_variables());
+    std::vector<uint8_t> buffer;
+    if (!reader_.Seek(ZKeySectionType::kIC)) return std::nullopt;
+    if (!ReadPoints<Curve>(&reader_, absl::MakeSpan(l_g1_query),
+                           l_g1_query.size(), &buffer)) {
+      return std::nullopt;
+    }
+    return zk::r1cs::groth16::VerifyingKey<Curve>(
+        std::move(points->alpha_g1), std::move(points->beta_g2),
+        std::move(points->gamma_g2), std::move(points->delta_g2),
+        std::move(l_g1_query));
+  }
+
+  // Same as |QuadraticArithmeticProgram<F>::WitnessMapFromMatrices()|, but
+  // evaluates A·z and B·z by streaming the coefficient section.
+  template <typename Domain>
+  std::optional<std::vector<F>> WitnessMapFromZKey(
+      const Domain* domain, absl::Span<const F> full_assignments) {
+    CHECK_EQ(domain->size(), domain_size());
+    CHECK_EQ(full_assignments.size(), size_t{reader_.header().num_vars});
+
+    uint32_t num_coefficients;
+    if (!reader_.Seek(ZKeySectionType::kCoefficients)) return std::nullopt;
+    if (!reader_.ReadInt(&num_coefficients)) return std::nullopt;
+
+    // The public input rows that snarkjs appends to A evaluate to the instance
+    // variables, which is exactly the padding circom's QAP reduction expects.
+    std::vector<F> a(domain->size());
+    std::vector<F> b(domain->size());
+    // The coefficients are much smaller than the points, so a chunk of
+    // coefficients stays well within the same budget.
+    std::vector<uint8_t> buffer(
+        std::min<size_t>(chunk_size_, num_coefficients) * kCoefficientSize);
+    for (size_t offset = 0; offset < num_coefficients; offset += chunk_size_) {
+      size_t len = std::min(chunk_size_, num_coefficients - offset);
+      if (!reader_.Read(buffer.data(), len * kCoefficientSize))
+        return std::nullopt;
+      for (size_t i = 0; i < len; ++i) {
+        const uint8_t* ptr = &buffer[i * kCoefficientSize];
+        uint32_t matrix;
+        uint32_t constraint;
+        uint32_t signal;
+        memcpy(&matrix, ptr, sizeof(uint32_t));
+        memcpy(&constraint, ptr + 4, sizeof(uint32_t));
+        memcpy(&signal, ptr + 8, sizeof(uint32_t));
+        if (constraint >= domain->size() ||
+            signal >= full_assignments.size()) {
+          LOG(ERROR) << "Coefficient " << offset + i << " is out of range";
+          return std::nullopt;
+        }
+        F term = CoefficientFromBytes<F>(ptr + 12);
+        term *= full_assignments[signal];
+        if (matrix == 0) {
+          a[constraint] += term;
+        } else {
+          b[constraint] += term;
+        }
+      }
+    }
+    return WitnessMap<F>::ComputeHEvals(domain, std::move(a), std::move(b));
+  }
+
+  std::optional<zk::r1cs::groth16::Proof<Curve>> CreateProofZK(
+      absl::Span<const F> h_evals, absl::Span<const F> full_assignments) {
+    return CreateProof(F::Random(), F::Random(), h_evals, full_assignments);
+  }
+
+  // Computes the proof as in |AssembleProof()|, streaming each MSM.
+  std::optional<zk::r1cs::groth16::Proof<Curve>> CreateProof(
+      const F& r, const F& s, absl::Span<const F> h_evals,
+      absl::Span<const F> full_assignments) {
+    CHECK_EQ(h_evals.size(), domain_size());
+    CHECK_EQ(full_assignments.size(), size_t{reader_.header().num_vars});
+
+    std::optional<ZKeyGroth16Points<Curve>> points =
+        ReadGroth16Points<Curve>(&reader_);
+    if (!points) return std::nullopt;
+
+    std::optional<G1AffinePoint> a_acc =
+        StreamMSM<G1AffinePoint>(ZKeySectionType::kPointsA, full_assignments);
+    if (!a_acc) return std::nullopt;
+    std::optional<G1AffinePoint> b1_acc =
+        StreamMSM<G1AffinePoint>(ZKeySectionType::kPointsB1, full_assignments);
+    if (!b1_acc) return std::nullopt;
+    std::optional<G2AffinePoint> b2_acc =
+        StreamMSM<G2AffinePoint>(ZKeySectionType::kPointsB2, full_assignments);
+    if (!b2_acc) return std::nullopt;
+    std::optional<G1AffinePoint> c_acc = StreamMSM<G1AffinePoint>(
+        ZKeySectionType::kPointsC,
+        full_assignments.subspan(num_instance_variables()));
+    if (!c_acc) return std::nullopt;
+    std::optional<G1AffinePoint> h_acc =
+        StreamMSM<G1AffinePoint>(ZKeySectionType::kPointsH, h_evals);
+    if (!h_acc) return std::nullopt;
+
+    ProofMSMs<Curve> msms{*a_acc, *b1_acc, *b2_acc, *c_acc, *h_acc};
+    return AssembleProof<Curve>(points->alpha_g1, points->beta_g1,
+                                points->beta_g2, points->delta_g1,
+                                points->delta_g2, msms, r, s);
+  }
+
+ private:
+  // Computes Σ sᵢ·Pᵢ over the points Pᵢ of |type| and the |scalars|, reading
+  // at most |chunk_size_| points at a time.
+  template <typename Point>
+  std::optional<Point> StreamMSM(ZKeySectionType type,
+                                 absl::Span<const F> scalars) {
+    using Bucket = typename math::VariableBaseMSM<Point>::Bucket;
+    constexpr size_t kPointSize = GetPointByteSize<Curve, Point>();
+
+    uint64_t section_size;
+    if (!reader_.Seek(type, &section_size)) return std::nullopt;
+    if (section_size != scalars.size() * kPointSize) {
+      LOG(ERROR) << "Section " << static_cast<uint32_t>(type) << " has "
+                 << section_size / kPointSize << " points, but "
+                 << scalars.size() << " scalars are given";
+      return std::nullopt;
+    }
+
+    std::vector<uint8_t> buffer;
+    std::vector<Point> bases;
+    Bucket acc = Bucket::Zero();
+    for (size_t offset = 0; offset < scalars.size(); offset += chunk_size_) {
+      size_t len = std::min(chunk_size_, scalars.size() - offset);
+      bases.resize(len);
+      if (!ReadPoints<Curve>(&reader_, absl::MakeSpan(bases), len, &buffer)) {
+        return std::nullopt;
+      }
+
+      math::VariableBaseMSM<Point> msm;
+      Bucket partial;
+      CHECK(msm.Run(bases, scalars.subspan(offset, len), &partial));
+      acc += partial;
+    }
+    return acc.ToAffine();
+  }
+
+  ZKeySectionReader reader_;
+  size_t memory_limit_;
+  size_t chunk_size_ = 0;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_STREAMING_PROVER_H_
@@ -0,0 +1,135 @@
+#ifndef SRC_COMMON_WITNESS_MAP_H_
+#define SRC_COMMON_WITNESS_MAP_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/zk/r1cs/constraint_system/constraint_matrices.h"
+
+namespace tachyon::circom {
+
+// The same witness map as |QuadraticArithmeticProgram<F>|, split into its
+// steps so that callers can inspect or stream the intermediate evaluations.
+template <typename F>
+class WitnessMap {
+ public:
+  // Evaluates |a| = A·z and |b| = B·z over |domain|. Rows beyond the
+  // constraints of |a| are padded with the instance variables, as circom's QAP
+  // reduction does. The rows are split into contiguous blocks, one per thread.
+  template <typename Domain>
+  static void EvaluateConstraints(
+      const Domain* domain, const zk::r1cs::ConstraintMatrices<F>& matrices,
+      absl::Span<const F> full_assignments, std::vector<F>* a,
+      std::vector<F>* b) {
+    a->assign(domain->size(), F::Zero());
+    b->assign(domain->size(), F::Zero());
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < matrices.num_constraints; ++i) {
+      (*a)[i] = EvaluateRow(matrices.a[i], full_assignments);
+      (*b)[i] = EvaluateRow(matrices.b[i], full_assignments);
+    }
+    for (size_t i = 0; i < matrices.num_instance_variables; ++i) {
+      (*a)[matrices.num_constraints + i] = full_assignments[i];
+    }
+  }
+
+  // Returns the 2 * |domain->size()|-th root of unity, which generates the odd
+  // coset that h is evaluated on.
+  template <typename Domain>
+  static F GetCosetGenerator(const Domain* domain) {
+    std::unique_ptr<Domain> extended_domain =
+        Domain::Create(2 * domain->size());
+    return extended_domain->group_gen();
+  }
+
+  // Moves |evals| over |domain| to the evaluations over the coset generated
+  // by the 2 * |domain->size()|-th root of unity.
+  template <typename Domain>
+  static typename Domain::Evals ToCosetEvals(const Domain* domain,
+                                             std::vector<F>&& evals,
+                                             const F& root_of_unity) {
+    using Evals = typename Domain::Evals;
+    using DensePoly = typename Domain::DensePoly;
+
+    DensePoly poly = domain->IFFT(Evals(std::move(evals)));
+    Domain::DistributePowers(poly, root_of_unity);
+    return domain->FFT(std::move(poly));
+  }
+
+  // Computes the evaluations of h on the odd coset from the evaluations of
+  // |a| = A·z and |b| = B·z over |domain|, where the instance rows of |a| are
+  // already filled in. c = a ∘ b is used for the C·z evaluations, just like
+  // circom's QAP reduction, since circom zkeys don't carry the C matrix.
+  template <typename Domain>
+  static std::vector<F> ComputeHEvals(const Domain* domain, std::vector<F>&& a,
+                                      std::vector<F>&& b) {
+    return ComputeHEvals(domain, std::move(a), std::move(b),
+                         GetCosetGenerator(domain));
+  }
+
+  // Same as above, but takes the generator of the coset, so that callers
+  // mapping many witnesses over the same |domain| can compute it only once.
+  template <typename Domain>
+  static std::vector<F> ComputeHEvals(const Domain* domain, std::vector<F>&& a,
+                                      std::vector<F>&& b,
+                                      const F& root_of_unity) {
+    using Evals = typename Domain::Evals;
+
+    std::vector<F> c(domain->size());
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < c.size(); ++i) { c[i] = a[i] * b[i]; }
+
+    Evals a_evals = ToCosetEvals(domain, std::move(a), root_of_unity);
+    Evals b_evals = ToCosetEvals(domain, std::move(b), root_of_unity);
+    Evals c_evals = ToCosetEvals(domain, std::move(c), root_of_unity);
+
+    // |h_evals[i]| = |a[i]| * |b[i]| - |c[i]|
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < domain->size(); ++i) {
+      F& h_evals_i = a_evals.at(i);
+      h_evals_i *= b_evals[i];
+      h_evals_i -= c_evals[i];
+    }
+    return std::move(a_evals).TakeEvaluations();
+  }
+
+  // Same as |QuadraticArithmeticProgram<F>::WitnessMapFromMatrices()|, but
+  // for provers that are tight on memory. The rows of |matrices| are freed as
+  // soon as A·z and B·z are evaluated, since nothing reads them afterwards,
+  // while its sizes are kept for the rest of the prover.
+  template <typename Domain>
+  static std::vector<F> LeanWitnessMapFromMatrices(
+      const Domain* domain, zk::r1cs::ConstraintMatrices<F>* matrices,
+      absl::Span<const F> full_assignments) {
+    std::vector<F> a;
+    std::vector<F> b;
+    EvaluateConstraints(domain, *matrices, full_assignments, &a, &b);
+    ReleaseMatrices(matrices);
+    return ComputeHEvals(domain, std::move(a), std::move(b));
+  }
+
+  // Frees the rows of |matrices|, keeping the number of constraints and
+  // variables.
+  static void ReleaseMatrices(zk::r1cs::ConstraintMatrices<F>* matrices) {
+    zk::r1cs::Matrix<F>().swap(matrices->a);
+    zk::r1cs::Matrix<F>().swap(matrices->b);
+    zk::r1cs::Matrix<F>().swap(matrices->c);
+  }
+
+ private:
+  template <typename Row>
+  static F EvaluateRow(const Row& row, absl::Span<const F> full_assignments) {
+    F sum = F::Zero();
+    for (const auto& cell : row) {
+      sum += cell.coefficient * full_assignments[cell.index];
+    }
+    return sum;
+  }
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_WITNESS_MAP_H_
@@ -0,0 +1,191 @@
+#ifndef SRC_COMMON_ZKEY_LOADER_H_
+#define SRC_COMMON_ZKEY_LOADER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/zkey_section_reader.h"
+#include "tachyon/base/files/file_path.h"
+#include "tachyon/base/logging.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/zk/r1cs/constraint_system/constraint_matrices.h"
+#include "tachyon/zk/r1cs/groth16/proving_key.h"
+#include "tachyon/zk/r1cs/groth16/verifying_key.h"
+
+namespace tachyon::circom {
+
+// Loads a zkey straight into a native |ProvingKey<Curve>| and
+// |ConstraintMatrices<F>|. Unlike |ZKeyParser|, which parses every section
+// into its own snarkjs-form containers before they are converted one element
+// at a time, this reads each section chunk by chunk and converts the chunk in
+// parallel into the final container. So only one copy of the key is alive,
+// besides a chunk of raw bytes, and the conversion scales with the cores.
+template <typename Curve>
+class ZKeyLoader {
+ public:
+  using F = typename Curve::G1Curve::ScalarField;
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  constexpr static size_t kDefaultChunkSize = size_t{1} << 16;
+
+  explicit ZKeyLoader(size_t chunk_size = kDefaultChunkSize)
+      : chunk_size_(chunk_size) {}
+
+  [[nodiscard]] bool Load(
+      const base::FilePath& path,
+      zk::r1cs::groth16::ProvingKey<Curve>* proving_key,
+      zk::r1cs::ConstraintMatrices<F>* constraint_matrices) {
+    ZKeySectionReader reader;
+    if (!reader.Open(path)) return false;
+    const ZKeyGroth16Header& header = reader.header();
+
+    std::optional<ZKeyGroth16Points<Curve>> points =
+        ReadGroth16Points<Curve>(&reader);
+    if (!points) return false;
+
+    std::vector<G1AffinePoint> ic(header.num_public + 1);
+    std::vector<G1AffinePoint> a_g1_query(header.num_vars);
+    std::vector<G1AffinePoint> b_g1_query(header.num_vars);
+    std::vector<G2AffinePoint> b_g2_query(header.num_vars);
+    std::vector<G1AffinePoint> l_g1_query(header.num_vars - header.num_public -
+                                          1);
+    std::vector<G1AffinePoint> h_g1_query(header.domain_size);
+    if (!ReadSection(&reader, ZKeySectionType::kIC, absl::MakeSpan(ic)) ||
+        !ReadSection(&reader, ZKeySectionType::kPointsA,
+                     absl::MakeSpan(a_g1_query)) ||
+        !ReadSection(&reader, ZKeySectionType::kPointsB1,
+                     absl::MakeSpan(b_g1_query)) ||
+        !ReadSection(&reader, ZKeySectionType::kPointsB2,
+                     absl::MakeSpan(b_g2_query)) ||
+        !ReadSection(&reader, ZKeySectionType::kPointsC,
+                     absl::MakeSpan(l_g1_query)) ||
+        !ReadSection(&reader, ZKeySectionType::kPointsH,
+                     absl::MakeSpan(h_g1_query))) {
+      return false;
+    }
+    // The raw bytes of the points are dead from here.
+    buffer_ = std::vector<uint8_t>();
+
+    if (!ReadConstraintMatrices(&reader, constraint_matrices)) return false;
+
+    zk::r1cs::groth16::VerifyingKey<Curve> verifying_key(
+        std::move(points->alpha_g1), std::move(points->beta_g2),
+        std::move(points->gamma_g2), std::move(points->delta_g2),
+        std::move(ic));
+    *proving_key = zk::r1cs::groth16::ProvingKey<Curve>(
+        std::move(verifying_key), std::move(points->beta_g1),
+        std::move(points->delta_g1), std::move(a_g1_query),
+        std::move(b_g1_query), std::move(b_g2_query), std::move(h_g1_query),
+        std::move(l_g1_query));
+    return true;
+  }
+
+ private:
+  template <typename Point>
+  bool ReadSection(ZKeySectionReader* reader, ZKeySectionType type,
+                   absl::Span<Point> points) {
+    uint64_t size;
+    if (!reader->Seek(type, &size)) return false;
+    if (size != points.size() * GetPointByteSize<Curve, Point>()) {
+      LOG(ERROR) << "Section " << static_cast<uint32_t>(type) << " has "
+                 << size << " bytes, but expected " << points.size()
+                 << " points";
+      return false;
+    }
+    return ReadPoints<Curve>(reader, points, chunk_size_, &buffer_);
+  }
+
+  // snarkjs only stores A and B, and appends a row per instance variable to A
+  // after the constraints. Those rows are dropped here, since the witness map
+  // pads A·z with the instance variables itself.
+  bool ReadConstraintMatrices(
+      ZKeySectionReader* reader,
+      zk::r1cs::ConstraintMatrices<F>* constraint_matrices) {
+    constexpr size_t kCoefficientSize = GetCoefficientByteSize<F>();
+
+    const ZKeyGroth16Header& header = reader->header();
+    uint32_t num_coefficients;
+    if (!reader->Seek(ZKeySectionType::kCoefficients)) return false;
+    if (!reader->ReadInt(&num_coefficients)) return false;
+
+    zk::r1cs::Matrix<F> a(header.domain_size);
+    zk::r1cs::Matrix<F> b(header.domain_size);
+    size_t num_rows = 0;
+    std::vector<F> coefficients;
+    for (size_t offset = 0; offset < num_coefficients; offset += chunk_size_) {
+      size_t len = std::min(chunk_size_, num_coefficients - offset);
+      buffer_.resize(len * kCoefficientSize);
+      if (!reader->Read(buffer_.data(), buffer_.size())) return false;
+
+      // Converting the coefficients dominates, so it is done in parallel and
+      // only the cheap appends to the rows are left serial.
+      const uint8_t* ptr = buffer_.data();
+      coefficients.resize(len);
+      OPENMP_PARALLEL_FOR(size_t i = 0; i < len; ++i) {
+        coefficients[i] = CoefficientFromBytes<F>(
+            &ptr[i * kCoefficientSize + 3 * sizeof(uint32_t)]);
+      }
+      for (size_t i = 0; i < len; ++i) {
+        uint32_t ids[3];
+        memcpy(ids, &ptr[i * kCoefficientSize], sizeof(ids));
+        uint32_t matrix = ids[0];
+        uint32_t constraint = ids[1];
+        uint32_t signal = ids[2];
+        if (matrix > 1 || constraint >= header.domain_size ||
+            signal >= header.num_vars) {
+          LOG(ERROR) << "Coefficient " << offset + i << " is out of range";
+          return false;
+        }
+        zk::r1cs::Matrix<F>& m = matrix == 0 ? a : b;
+        m[constraint].push_back({std::move(coefficients[i]), signal});
+        num_rows = std::max(num_rows, size_t{constraint} + 1);
+      }
+    }
+    buffer_ = std::vector<uint8_t>();
+
+    if (num_rows < header.num_public + 1) {
+      LOG(ERROR) << "The zkey has no rows for the instance variables";
+      return false;
+    }
+    size_t num_constraints = num_rows - header.num_public - 1;
+    a.resize(num_constraints);
+    b.resize(num_constraints);
+
+    constraint_matrices->num_instance_variables = header.num_public + 1;
+    constraint_matrices->num_witness_variables =
+        header.num_vars - header.num_public - 1;
+    constraint_matrices->num_constraints = num_constraints;
+    constraint_matrices->a_num_non_zero = CountNonZero(a);
+    constraint_matrices->b_num_non_zero = CountNonZero(b);
+    constraint_matrices->c_num_non_zero = 0;
+    constraint_matrices->a = std::move(a);
+    constraint_matrices->b = std::move(b);
+    constraint_matrices->c.clear();
+    return true;
+  }
+
+  static size_t CountNonZero(const zk::r1cs::Matrix<F>& matrix) {
+    size_t ret = 0;
+    for (const auto& row : matrix) {
+      ret += row.size();
+    }
+    return ret;
+  }
+
+  size_t chunk_size_;
+  // The raw bytes of a chunk, reused across sections.
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_ZKEY_LOADER_H_
@@ -0,0 +1,46 @@
+#include "src/common/zkey_section_reader.h"
+
+#include "tachyon/base/logging.h"
+
+namespace tachyon::circom {
+
+namespace {
+
+constexpr uint32_t kGroth16ProtocolId = 1;
+
+}  // namespace
+
+bool ZKeySectionReader::Open(const base::FilePath& path) {
+  if (!file_.Open(path, "zkey")) return false;
+
+  uint32_t protocol;
+  if (!Seek(ZKeySectionType::kHeader)) return false;
+  if (!ReadInt(&protocol)) return false;
+  if (protocol != kGroth16ProtocolId) {
+    LOG(ERROR) << "Only groth16 zkeys are supported, but got protocol "
+               << protocol;
+    return false;
+  }
+
+  if (!Seek(ZKeySectionType::kGroth16Header)) return false;
+  if (!ReadInt(&header_.base_field_bytes)) return false;
+  if (!file_.Skip(header_.base_field_bytes)) return false;
+  if (!ReadInt(&header_.scalar_field_bytes)) return false;
+  if (!file_.Skip(header_.scalar_field_bytes)) return false;
+  if (!ReadInt(&header_.num_vars)) return false;
+  if (!ReadInt(&header_.num_public)) return false;
+  return ReadInt(&header_.domain_size);
+}
+
+bool ZKeySectionReader::Seek(ZKeySectionType type, uint64_t* size) {
+  return file_.Seek(static_cast<uint32_t>(type), size);
+}
+
+bool ZKeySectionReader::SeekGroth16Points() {
+  if (!Seek(ZKeySectionType::kGroth16Header)) return false;
+  // n8q, q, n8r, r, |num_vars|, |num_public| and |domain_size|.
+  return file_.Skip(sizeof(uint32_t) * 5 + header_.base_field_bytes +
+                    header_.scalar_field_bytes);
+}
+
+}  // namespace tachyon::circom
@@ -0,0 +1,234 @@
+#ifndef SRC_COMMON_ZKEY_SECTION_READER_H_
+#define SRC_COMMON_ZKEY_SECTION_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "src/common/bin_file_section_reader.h"
+#include "tachyon/base/files/file_path.h"
+#include "tachyon/base/openmp_util.h"
+#include "tachyon/math/base/big_int.h"
+
+namespace tachyon::circom {
+
+// Section ids of a snarkjs groth16 zkey file.
+enum class ZKeySectionType : uint32_t {
+  kHeader = 1,
+  kGroth16Header = 2,
+  kIC = 3,
+  kCoefficients = 4,
+  kPointsA = 5,
+  kPointsB1 = 6,
+  kPointsB2 = 7,
+  kPointsC = 8,
+  kPointsH = 9,
+  kContributions = 10,
+};
+
+// Sizes read from the groth16 header section. The curve points that follow
+// them in the same section are read separately by the caller.
+struct ZKeyGroth16Header {
+  uint32_t base_field_bytes = 0;
+  uint32_t scalar_field_bytes = 0;
+  uint32_t num_vars = 0;
+  uint32_t num_public = 0;
+  uint32_t domain_size = 0;
+};
+
+// Reads a zkey file section by section without loading it into memory, so
+// callers can stream point and coefficient sections in chunks of their
+// choosing.
+class ZKeySectionReader {
+ public:
+  ZKeySectionReader() = default;
+  ZKeySectionReader(const ZKeySectionReader& other) = delete;
+  ZKeySectionReader& operator=(const ZKeySectionReader& other) = delete;
+
+  const ZKeyGroth16Header& header() const { return header_; }
+
+  // Opens |path|, builds the section table and reads the groth16 header. The
+  // stream is left right after the scalar field modulus of the groth16
+  // header, i.e., at |num_vars|; use |SeekGroth16Points()| to read the points.
+  [[nodiscard]] bool Open(const base::FilePath& path);
+
+  // Moves the stream to the beginning of |type| and returns its size in
+  // |size| if it is not null.
+  [[nodiscard]] bool Seek(ZKeySectionType type, uint64_t* size = nullptr);
+
+  // Moves the stream to alpha₁ inside the groth16 header section.
+  [[nodiscard]] bool SeekGroth16Points();
+
+  [[nodiscard]] bool Read(void* dst, size_t size) {
+    return file_.Read(dst, size);
+  }
+
+  template <typename T>
+  [[nodiscard]] bool ReadInt(T* value) {
+    return file_.ReadInt(value);
+  }
+
+ private:
+  BinFileSectionReader file_;
+  ZKeyGroth16Header header_;
+};
+
+// Decodes a little-endian field element stored in montgomery form, which is
+// how snarkjs stores every coordinate in a zkey.
+template <typename F>
+F FieldFromMontgomeryBytes(const uint8_t* bytes) {
+  math::BigInt<F::kLimbNums> big_int;
+  memcpy(big_int.limbs, bytes, sizeof(big_int.limbs));
+  return F::FromMontgomery(big_int);
+}
+
+// Decodes a matrix coefficient of the coefficients section. snarkjs stores
+// them multiplied by R² rather than R, so montgomery reduction is applied
+// twice.
+template <typename F>
+F CoefficientFromBytes(const uint8_t* bytes) {
+  return F::FromMontgomery(FieldFromMontgomeryBytes<F>(bytes).ToBigInt());
+}
+
+template <typename F>
+constexpr size_t GetFieldByteSize() {
+  return F::kLimbNums * sizeof(uint64_t);
+}
+
+// An entry of the coefficients section is the matrix, the constraint and the
+// signal followed by the coefficient.
+template <typename F>
+constexpr size_t GetCoefficientByteSize() {
+  return 3 * sizeof(uint32_t) + GetFieldByteSize<F>();
+}
+
+template <typename AffinePoint>
+constexpr size_t GetG1ByteSize() {
+  return 2 * GetFieldByteSize<typename AffinePoint::BaseField>();
+}
+
+template <typename AffinePoint>
+constexpr size_t GetG2ByteSize() {
+  return 4 * GetFieldByteSize<
+                 typename AffinePoint::BaseField::BasePrimeField>();
+}
+
+// snarkjs writes the point at infinity as (0, 0).
+template <typename AffinePoint>
+AffinePoint G1FromBytes(const uint8_t* bytes) {
+  using BaseField = typename AffinePoint::BaseField;
+  constexpr size_t kFieldSize = GetFieldByteSize<BaseField>();
+
+  BaseField x = FieldFromMontgomeryBytes<BaseField>(bytes);
+  BaseField y = FieldFromMontgomeryBytes<BaseField>(bytes + kFieldSize);
+  if (x.IsZero() && y.IsZero()) return AffinePoint::Zero();
+  return AffinePoint(std::move(x), std::move(y));
+}
+
+template <typename AffinePoint>
+AffinePoint G2FromBytes(const uint8_t* bytes) {
+  using BaseField = typename AffinePoint::BaseField;
+  using BasePrimeField = typename BaseField::BasePrimeField;
+  constexpr size_t kFieldSize = GetFieldByteSize<BasePrimeField>();
+
+  BaseField x(FieldFromMontgomeryBytes<BasePrimeField>(bytes),
+              FieldFromMontgomeryBytes<BasePrimeField>(bytes + kFieldSize));
+  BaseField y(
+      FieldFromMontgomeryBytes<BasePrimeField>(bytes + 2 * kFieldSize),
+      FieldFromMontgomeryBytes<BasePrimeField>(bytes + 3 * kFieldSize));
+  if (x.IsZero() && y.IsZero()) return AffinePoint::Zero();
+  return AffinePoint(std::move(x), std::move(y));
+}
+
+template <typename Curve, typename Point>
+constexpr size_t GetPointByteSize() {
+  if constexpr (std::is_same_v<Point, typename Curve::G1Curve::AffinePoint>) {
+    return GetG1ByteSize<Point>();
+  } else {
+    return GetG2ByteSize<Point>();
+  }
+}
+
+template <typename Curve, typename Point>
+Point PointFromBytes(const uint8_t* bytes) {
+  if constexpr (std::is_same_v<Point, typename Curve::G1Curve::AffinePoint>) {
+    return G1FromBytes<Point>(bytes);
+  } else {
+    return G2FromBytes<Point>(bytes);
+  }
+}
+
+// Reads |points.size()| points from the current position of |reader|,
+// |chunk_size| at a time, converting each chunk in parallel. |buffer| holds
+// the raw bytes of a chunk and can be reused across calls.
+template <typename Curve, typename Point>
+[[nodiscard]] bool ReadPoints(ZKeySectionReader* reader,
+                              absl::Span<Point> points, size_t chunk_size,
+                              std::vector<uint8_t>* buffer) {
+  constexpr size_t kPointSize = GetPointByteSize<Curve, Point>();
+
+  buffer->resize(std::min(chunk_size, points.size()) * kPointSize);
+  for (size_t offset = 0; offset < points.size(); offset += chunk_size) {
+    size_t len = std::min(chunk_size, points.size() - offset);
+    if (!reader->Read(buffer->data(), len * kPointSize)) return false;
+    const uint8_t* ptr = buffer->data();
+    OPENMP_PARALLEL_FOR(size_t i = 0; i < len; ++i) {
+      points[offset + i] = PointFromBytes<Curve, Point>(&ptr[i * kPointSize]);
+    }
+  }
+  return true;
+}
+
+// The curve points of the groth16 header section.
+template <typename Curve>
+struct ZKeyGroth16Points {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+
+  G1AffinePoint alpha_g1;
+  G1AffinePoint beta_g1;
+  G2AffinePoint beta_g2;
+  G2AffinePoint gamma_g2;
+  G1AffinePoint delta_g1;
+  G2AffinePoint delta_g2;
+};
+
+template <typename Curve>
+std::optional<ZKeyGroth16Points<Curve>> ReadGroth16Points(
+    ZKeySectionReader* reader) {
+  using G1AffinePoint = typename Curve::G1Curve::AffinePoint;
+  using G2AffinePoint = typename Curve::G2Curve::AffinePoint;
+  constexpr size_t kG1Size = GetG1ByteSize<G1AffinePoint>();
+  constexpr size_t kG2Size = GetG2ByteSize<G2AffinePoint>();
+
+  uint8_t buffer[3 * kG1Size + 3 * kG2Size];
+  if (!reader->SeekGroth16Points()) return std::nullopt;
+  if (!reader->Read(buffer, sizeof(buffer))) return std::nullopt;
+
+  ZKeyGroth16Points<Curve> points;
+  const uint8_t* ptr = buffer;
+  points.alpha_g1 = G1FromBytes<G1AffinePoint>(ptr);
+  ptr += kG1Size;
+  points.beta_g1 = G1FromBytes<G1AffinePoint>(ptr);
+  ptr += kG1Size;
+  points.beta_g2 = G2FromBytes<G2AffinePoint>(ptr);
+  ptr += kG2Size;
+  points.gamma_g2 = G2FromBytes<G2AffinePoint>(ptr);
+  ptr += kG2Size;
+  points.delta_g1 = G1FromBytes<G1AffinePoint>(ptr);
+  ptr += kG1Size;
+  points.delta_g2 = G2FromBytes<G2AffinePoint>(ptr);
+  return points;
+}
+
+}  // namespace tachyon::circom
+
+#endif  // SRC_COMMON_ZKEY_SECTION_READER_H_
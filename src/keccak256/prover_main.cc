@@ -3,15 +3,22 @@
 
 #include <chrono>
 #include <iostream>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/types/span.h"
 #include "openssl/sha.h"
+#include "src/common/perf_counters.h"
+#include "src/common/phased_prove.h"
+#include "src/common/r1cs_checker.h"
+#include "src/common/rerandomize.h"
+#include "src/common/zkey_loader.h"
 
 #include "circomlib/circuit/quadratic_arithmetic_program.h"
 #include "circomlib/circuit/witness_loader.h"
-#include "circomlib/zkey/zkey_parser.h"
+#include "tachyon/base/flag/flag_parser.h"
 #include "tachyon/base/logging.h"
 #include "tachyon/math/elliptic_curves/bn/bn254/bn254.h"
 #include "tachyon/math/polynomials/univariate/univariate_evaluation_domain_factory.h"
@@ -64,6 +71,34 @@ void CheckPublicInput(const std::vector<uint8_t> &in,
 }
 
 int RealMain(int argc, char **argv) {
+  bool check_r1cs = false;
+  std::string perf_json;
+  base::FlagParser parser;
+  parser.AddFlag<base::BoolFlag>(&check_r1cs)
+      .set_long_name("--check_r1cs")
+      .set_help(
+          "Whether to check the witness against the constraints before "
+          "proving. By default, false.");
+  parser.AddFlag<base::Flag<std::string>>(&perf_json)
+      .set_long_name("--perf_json")
+      .set_help(
+          "Writes the wall time, hardware counters and peak RSS of each "
+          "proving phase to this JSON file. By default, empty, which disables "
+          "profiling.");
+  {
+    std::string error;
+    if (!parser.Parse(argc, argv, &error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+  }
+
+  // Created before |Curve::Init()|, so that the counters are inherited by the
+  // OpenMP workers.
+  std::optional<PhaseProfiler> phase_profiler;
+  if (!perf_json.empty()) phase_profiler.emplace("keccak256");
+  PhaseProfiler *profiler = phase_profiler ? &*phase_profiler : nullptr;
+
   auto start_time = std::chrono::high_resolution_clock::now();
   constexpr size_t MaxDegree = (size_t{1} << 32) - 1;
   using Domain = math::UnivariateEvaluationDomain<F, MaxDegree>;
@@ -74,14 +109,11 @@ int RealMain(int argc, char **argv) {
   zk::r1cs::groth16::ProvingKey<Curve> proving_key;
   zk::r1cs::ConstraintMatrices<F> constraint_matrices;
   {
-    ZKeyParser zkey_parser;
-    std::unique_ptr<ZKey> zkey = zkey_parser.Parse(
-        base::FilePath("circuits/keccak256/keccak_main.zkey"));
-    CHECK(zkey);
-
-    proving_key = std::move(*zkey).TakeProvingKey().ToNativeProvingKey<Curve>();
-    constraint_matrices =
-        std::move(*zkey).TakeConstraintMatrices().ToNative<F>();
+    ScopedPhase zkey_phase(profiler, "zkey");
+    ZKeyLoader<Curve> zkey_loader;
+    CHECK(zkey_loader.Load(
+        base::FilePath("circuits/keccak256/keccak_main.zkey"), &proving_key,
+        &constraint_matrices));
   }
 
   auto zkey_end_time = std::chrono::high_resolution_clock::now();
@@ -92,6 +124,7 @@ int RealMain(int argc, char **argv) {
             << std::endl;
 
   auto wtns_start_time = std::chrono::high_resolution_clock::now();
+  ScopedPhase wtns_phase(profiler, "witness");
 
   WitnessLoader<F> witness_loader(
       base::FilePath("circuits/keccak256/keccak_main_cpp/keccak_main.dat"));
@@ -128,6 +161,7 @@ int RealMain(int argc, char **argv) {
           constraint_matrices.num_witness_variables,
       [&witness_loader](size_t i) { return witness_loader.Get(i); });
 
+  wtns_phase.End();
   auto wtns_end_time = std::chrono::high_resolution_clock::now();
   auto wtns_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
       wtns_end_time - wtns_start_time);
@@ -142,22 +176,54 @@ int RealMain(int argc, char **argv) {
   // CHECK_EQ(public_inputs.size(), size_t{256});
   // CheckPublicInput(in, public_inputs);
 
+  std::optional<R1CSChecker<F>> r1cs_checker;
+  if (check_r1cs) {
+    ScopedPhase r1cs_phase(profiler, "r1cs");
+    r1cs_checker.emplace();
+    CHECK(r1cs_checker->Load(
+        base::FilePath("circuits/keccak256/keccak_main.r1cs")));
+  }
+
   auto prove_start_time = std::chrono::high_resolution_clock::now();
+  ScopedPhase prove_phase(profiler, "prove");
+  ScopedPhase witness_map_phase(profiler, "witness_map");
   std::unique_ptr<Domain> domain =
       Domain::Create(constraint_matrices.num_constraints +
                      constraint_matrices.num_instance_variables);
-  std::vector<F> h_evals =
-      QuadraticArithmeticProgram<F>::WitnessMapFromMatrices(
-          domain.get(), constraint_matrices, full_assignments);
-
-  zk::r1cs::groth16::Proof<Curve> proof =
-      zk::r1cs::groth16::CreateProofWithAssignmentZK(
-          proving_key, absl::MakeConstSpan(h_evals),
-          absl::MakeConstSpan(full_assignments)
-              .subspan(1, constraint_matrices.num_instance_variables - 1),
-          absl::MakeConstSpan(full_assignments)
-              .subspan(constraint_matrices.num_instance_variables),
-          absl::MakeConstSpan(full_assignments).subspan(1));
+  std::vector<F> h_evals;
+  if (r1cs_checker) {
+    std::optional<std::vector<F>> checked_h_evals =
+        r1cs_checker->WitnessMapFromMatrices(
+            domain.get(), &constraint_matrices, full_assignments,
+            /*release_matrices=*/false);
+    if (!checked_h_evals) {
+      std::cerr << "The witness doesn't satisfy the constraints" << std::endl;
+      return 1;
+    }
+    h_evals = std::move(*checked_h_evals);
+  } else {
+    h_evals = QuadraticArithmeticProgram<F>::WitnessMapFromMatrices(
+        domain.get(), constraint_matrices, full_assignments);
+  }
+  witness_map_phase.End();
+
+  zk::r1cs::groth16::Proof<Curve> proof;
+  if (profiler) {
+    // Runs the MSMs one by one, so that each gets its own counters.
+    proof = CreateProofWithPhases(
+        proving_key, absl::MakeConstSpan(h_evals),
+        absl::MakeConstSpan(full_assignments),
+        constraint_matrices.num_instance_variables, profiler);
+  } else {
+    proof = zk::r1cs::groth16::CreateProofWithAssignmentZK(
+        proving_key, absl::MakeConstSpan(h_evals),
+        absl::MakeConstSpan(full_assignments)
+            .subspan(1, constraint_matrices.num_instance_variables - 1),
+        absl::MakeConstSpan(full_assignments)
+            .subspan(constraint_matrices.num_instance_variables),
+        absl::MakeConstSpan(full_assignments).subspan(1));
+  }
+  prove_phase.End();
   auto prove_end_time = std::chrono::high_resolution_clock::now();
   auto prove_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
       prove_end_time - prove_start_time);
@@ -174,8 +240,29 @@ int RealMain(int argc, char **argv) {
 
   zk::r1cs::groth16::PreparedVerifyingKey<Curve> prepared_verifying_key =
       std::move(proving_key).TakeVerifyingKey().ToPreparedVerifyingKey();
-  CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key, proof,
-                                       public_inputs));
+  {
+    ScopedPhase verify_phase(profiler, "verify");
+    CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key, proof,
+                                         public_inputs));
+  }
+
+  auto rerandomize_start_time = std::chrono::high_resolution_clock::now();
+  zk::r1cs::groth16::Proof<Curve> rerandomized_proof =
+      RerandomizeProof(prepared_verifying_key.verifying_key(), proof);
+  auto rerandomize_end_time = std::chrono::high_resolution_clock::now();
+  auto rerandomize_duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          rerandomize_end_time - rerandomize_start_time);
+
+  std::cout << "Rerandomize time: " << rerandomize_duration.count()
+            << " microseconds" << std::endl;
+  CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key,
+                                       rerandomized_proof, public_inputs));
+
+  if (profiler && !profiler->WriteJson(perf_json)) {
+    std::cerr << "Failed to write " << perf_json << std::endl;
+    return 1;
+  }
   return 0;
 }
 
@@ -2,11 +2,18 @@
 #include <stdint.h>
 
 #include <iostream>
+#include <string>
 #include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "src/common/batch_prover.h"
+#include "src/common/rerandomize.h"
 
 #include "circomlib/circuit/quadratic_arithmetic_program.h"
 #include "circomlib/circuit/witness_loader.h"
 #include "circomlib/zkey/zkey_parser.h"
+#include "tachyon/base/flag/flag_parser.h"
 #include "tachyon/base/logging.h"
 #include "tachyon/math/elliptic_curves/bn/bn254/bn254.h"
 #include "tachyon/math/polynomials/univariate/univariate_evaluation_domain_factory.h"
@@ -21,6 +28,21 @@ using F = bn254::Fr;
 using Curve = math::bn254::BN254Curve;
 
 int RealMain(int argc, char **argv) {
+  size_t batch_size = 0;
+  base::FlagParser parser;
+  parser.AddFlag<base::Flag<size_t>>(&batch_size)
+      .set_long_name("--batch_size")
+      .set_help(
+          "The number of extra proofs to create at once with the batch "
+          "prover. By default, 0.");
+  {
+    std::string error;
+    if (!parser.Parse(argc, argv, &error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+  }
+
   constexpr size_t MaxDegree = (size_t{1} << 2) - 1;
   using Domain = math::UnivariateEvaluationDomain<F, MaxDegree>;
 
@@ -78,10 +100,23 @@ int RealMain(int argc, char **argv) {
 
   std::cout << proof.ToString() << std::endl;
 
+  if (batch_size > 0) {
+    RunBatchBenchmark<Curve, Domain>(
+        proving_key, constraint_matrices, &witness_loader, batch_size,
+        [](WitnessLoader<F> *witness_loader) {
+          witness_loader->Set("in", {F::Random(), F::Random(), F::Random()});
+        });
+  }
+
   zk::r1cs::groth16::PreparedVerifyingKey<Curve> prepared_verifying_key =
       std::move(proving_key).TakeVerifyingKey().ToPreparedVerifyingKey();
   CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key, proof,
                                        public_inputs));
+
+  zk::r1cs::groth16::Proof<Curve> rerandomized_proof =
+      RerandomizeProof(prepared_verifying_key.verifying_key(), proof);
+  CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key,
+                                       rerandomized_proof, public_inputs));
   return 0;
 }
 
@@ -3,15 +3,27 @@
 
 #include <chrono>
 #include <iostream>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/types/span.h"
 #include "openssl/sha.h"
+#include "src/common/aggregation_benchmark.h"
+#include "src/common/memory_usage.h"
+#include "src/common/partial_input_verifier.h"
+#include "src/common/perf_counters.h"
+#include "src/common/phased_prove.h"
+#include "src/common/r1cs_checker.h"
+#include "src/common/rerandomize.h"
+#include "src/common/streaming_prover.h"
+#include "src/common/witness_map.h"
+#include "src/common/zkey_loader.h"
 
 #include "circomlib/circuit/quadratic_arithmetic_program.h"
 #include "circomlib/circuit/witness_loader.h"
-#include "circomlib/zkey/zkey_parser.h"
+#include "tachyon/base/flag/flag_parser.h"
 #include "tachyon/base/logging.h"
 #include "tachyon/math/elliptic_curves/bn/bn254/bn254.h"
 #include "tachyon/math/polynomials/univariate/univariate_evaluation_domain_factory.h"
@@ -63,39 +75,7 @@ void CheckPublicInput(const std::vector<uint8_t> &in,
   CHECK(uint8_vec == result_vec);
 }
 
-int RealMain(int argc, char **argv) {
-  auto start_time = std::chrono::high_resolution_clock::now();
-  constexpr size_t MaxDegree = (size_t{1} << 32) - 1;
-  using Domain = math::UnivariateEvaluationDomain<F, MaxDegree>;
-
-  Curve::Init();
-
-  auto zkey_start_time = std::chrono::high_resolution_clock::now();
-  zk::r1cs::groth16::ProvingKey<Curve> proving_key;
-  zk::r1cs::ConstraintMatrices<F> constraint_matrices;
-  {
-    ZKeyParser zkey_parser;
-    std::unique_ptr<ZKey> zkey =
-        zkey_parser.Parse(base::FilePath("circuits/rsa/rsa_main.zkey"));
-    CHECK(zkey);
-
-    proving_key = std::move(*zkey).TakeProvingKey().ToNativeProvingKey<Curve>();
-    constraint_matrices =
-        std::move(*zkey).TakeConstraintMatrices().ToNative<F>();
-  }
-
-  auto zkey_end_time = std::chrono::high_resolution_clock::now();
-  auto zkey_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-      zkey_end_time - zkey_start_time);
-
-  std::cout << "zkey time: " << zkey_duration.count() << " milliseconds"
-            << std::endl;
-
-  auto wtns_start_time = std::chrono::high_resolution_clock::now();
-
-  WitnessLoader<F> witness_loader(
-      base::FilePath("circuits/rsa/rsa_main_cpp/rsa_main.dat"));
-
+void SetInputs(WitnessLoader<F> *witness_loader) {
   // Signature values
   std::vector<F> signature = {
       F(3582320600048169363ULL),  F(7163546589759624213ULL),
@@ -167,23 +147,294 @@ int RealMain(int argc, char **argv) {
                                  F(0ULL),
                                  F(0ULL),
                                  F(0ULL)};
-  witness_loader.Set("signature", signature);
-  witness_loader.Set("modulus", modulus);
-  witness_loader.Set("base_message", base_message);
-  // witness_loader.Set("in", Uint8ToBitVector<F>(in));
-  witness_loader.Load();
+  witness_loader->Set("signature", signature);
+  witness_loader->Set("modulus", modulus);
+  witness_loader->Set("base_message", base_message);
+}
+
+// Verifies |proof| with the modulus folded into |verifying_key|, as a
+// deployment checking many signatures against the same modulus would, and
+// compares it with the regular verification. Each verification is its own
+// phase of |profiler|, which may be null.
+void VerifyWithFixedModulus(
+    const zk::r1cs::groth16::PreparedVerifyingKey<Curve> &verifying_key,
+    const zk::r1cs::groth16::Proof<Curve> &proof,
+    absl::Span<const F> public_inputs, PhaseProfiler *profiler) {
+  // The modulus is the only public input of the circuit.
+  std::vector<std::optional<F>> fixed_inputs(public_inputs.begin(),
+                                             public_inputs.end());
+  PartialInputVerifier<Curve> verifier(&verifying_key, fixed_inputs);
+
+  auto verify_start_time = std::chrono::high_resolution_clock::now();
+  {
+    ScopedPhase verify_phase(profiler, "verify");
+    CHECK(zk::r1cs::groth16::VerifyProof(verifying_key, proof, public_inputs));
+  }
+  auto verify_end_time = std::chrono::high_resolution_clock::now();
+  {
+    ScopedPhase fixed_verify_phase(profiler, "verify_fixed_modulus");
+    CHECK(verifier.Verify(proof, {}));
+  }
+  auto fixed_verify_end_time = std::chrono::high_resolution_clock::now();
+  auto verify_duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      verify_end_time - verify_start_time);
+  auto fixed_verify_duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          fixed_verify_end_time - verify_end_time);
+
+  std::cout << "Verify time: " << verify_duration.count() << " microseconds"
+            << std::endl;
+  std::cout << "Verify time with fixed modulus: "
+            << fixed_verify_duration.count() << " microseconds" << std::endl;
+}
 
-  std::vector<F> full_assignments = base::CreateVector(
-      constraint_matrices.num_instance_variables +
-          constraint_matrices.num_witness_variables,
-      [&witness_loader](size_t i) { return witness_loader.Get(i); });
+// Checks |PartialInputVerifier| with the last limb of the modulus left to vary
+// per proof, both with and without the fixed-base tables. It should accept
+// |proof| and reject it once that limb is changed.
+void CheckVariableInput(
+    const zk::r1cs::groth16::PreparedVerifyingKey<Curve> &verifying_key,
+    const zk::r1cs::groth16::Proof<Curve> &proof,
+    absl::Span<const F> public_inputs) {
+  std::vector<std::optional<F>> fixed_inputs(public_inputs.begin(),
+                                             public_inputs.end());
+  fixed_inputs.back() = std::nullopt;
+  F variable_input = public_inputs.back();
+  F wrong_input = variable_input + F::One();
+  for (bool use_fixed_base_tables : {false, true}) {
+    PartialInputVerifier<Curve> verifier(&verifying_key, fixed_inputs,
+                                         use_fixed_base_tables);
+    CHECK_EQ(verifier.num_variable_inputs(), size_t{1});
+    CHECK(verifier.Verify(proof, absl::MakeConstSpan(&variable_input, 1)));
+    CHECK(!verifier.Verify(proof, absl::MakeConstSpan(&wrong_input, 1)));
+  }
+}
+
+// Runs the witness calculator on the inputs of |SetInputs()| and returns the
+// first |num_variables| full assignments. The witness calculator is freed on
+// return, since nothing reads it once the assignments are copied out.
+std::vector<F> CalculateWitness(size_t num_variables,
+                                PhaseProfiler *profiler) {
+  auto wtns_start_time = std::chrono::high_resolution_clock::now();
+  ScopedPhase wtns_phase(profiler, "witness");
+
+  std::vector<F> full_assignments;
+  {
+    WitnessLoader<F> witness_loader(
+        base::FilePath("circuits/rsa/rsa_main_cpp/rsa_main.dat"));
+
+    SetInputs(&witness_loader);
+    // witness_loader.Set("in", Uint8ToBitVector<F>(in));
+    witness_loader.Load();
+
+    full_assignments = base::CreateVector(
+        num_variables,
+        [&witness_loader](size_t i) { return witness_loader.Get(i); });
+  }
 
+  wtns_phase.End();
   auto wtns_end_time = std::chrono::high_resolution_clock::now();
   auto wtns_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
       wtns_end_time - wtns_start_time);
 
   std::cout << "calc witness time: " << wtns_duration.count() << " milliseconds"
             << std::endl;
+  return full_assignments;
+}
+
+// Prints the total time since |start_time|, the peak RSS and |proof|. Then
+// verifies |proof| with and without the fixed modulus and checks that a
+// re-randomization of it verifies too.
+void FinishProof(
+    std::chrono::high_resolution_clock::time_point start_time,
+    const zk::r1cs::groth16::PreparedVerifyingKey<Curve> &verifying_key,
+    const zk::r1cs::groth16::Proof<Curve> &proof,
+    absl::Span<const F> public_inputs, PhaseProfiler *profiler) {
+  auto end_time = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      end_time - start_time);
+  std::cout << "====Total time: " << duration.count()
+            << " milliseconds====" << std::endl;
+  std::cout << "Peak RSS: " << ToMebibytes(GetPeakRSSInBytes()) << " MiB"
+            << std::endl;
+  std::cout << proof.ToString() << std::endl;
+
+  VerifyWithFixedModulus(verifying_key, proof, public_inputs, profiler);
+  CheckVariableInput(verifying_key, proof, public_inputs);
+
+  auto rerandomize_start_time = std::chrono::high_resolution_clock::now();
+  zk::r1cs::groth16::Proof<Curve> rerandomized_proof =
+      RerandomizeProof(verifying_key.verifying_key(), proof);
+  auto rerandomize_end_time = std::chrono::high_resolution_clock::now();
+  auto rerandomize_duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          rerandomize_end_time - rerandomize_start_time);
+
+  std::cout << "Rerandomize time: " << rerandomize_duration.count()
+            << " microseconds" << std::endl;
+  CHECK(zk::r1cs::groth16::VerifyProof(verifying_key, rerandomized_proof,
+                                       public_inputs));
+}
+
+template <typename Domain>
+int RunStreaming(size_t memory_limit) {
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  StreamingProver<Curve> prover(memory_limit);
+  // |Open()| logs why the zkey or the limit was rejected.
+  if (!prover.Open(base::FilePath("circuits/rsa/rsa_main.zkey"))) return 1;
+  std::cout << "chunk size: " << prover.chunk_size() << " points" << std::endl;
+
+  // The witness calculator isn't counted in the limit, but it is freed
+  // before proving.
+  std::vector<F> full_assignments = CalculateWitness(
+      prover.num_instance_variables() + prover.num_witness_variables(),
+      /*profiler=*/nullptr);
+
+  absl::Span<const F> public_inputs =
+      absl::MakeConstSpan(full_assignments)
+          .subspan(1, prover.num_instance_variables() - 1);
+
+  auto prove_start_time = std::chrono::high_resolution_clock::now();
+  std::unique_ptr<Domain> domain = Domain::Create(prover.domain_size());
+  std::optional<std::vector<F>> h_evals =
+      prover.WitnessMapFromZKey(domain.get(), full_assignments);
+  CHECK(h_evals);
+
+  std::optional<zk::r1cs::groth16::Proof<Curve>> proof =
+      prover.CreateProofZK(absl::MakeConstSpan(*h_evals), full_assignments);
+  CHECK(proof);
+  size_t peak_rss = GetPeakRSSInBytes();
+  if (peak_rss > memory_limit) {
+    std::cerr << "Warning: the peak RSS of " << ToMebibytes(peak_rss)
+              << " MiB exceeded the memory limit of "
+              << ToMebibytes(memory_limit) << " MiB" << std::endl;
+  }
+  auto prove_end_time = std::chrono::high_resolution_clock::now();
+  auto prove_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      prove_end_time - prove_start_time);
+
+  std::cout << "Prove time: " << prove_duration.count() << " milliseconds"
+            << std::endl;
+
+  std::optional<zk::r1cs::groth16::VerifyingKey<Curve>> verifying_key =
+      prover.ReadVerifyingKey();
+  CHECK(verifying_key);
+  zk::r1cs::groth16::PreparedVerifyingKey<Curve> prepared_verifying_key =
+      std::move(*verifying_key).ToPreparedVerifyingKey();
+  FinishProof(start_time, prepared_verifying_key, *proof, public_inputs,
+              /*profiler=*/nullptr);
+  return 0;
+}
+
+int RealMain(int argc, char **argv) {
+  size_t memory_limit_mb = 0;
+  bool check_r1cs = false;
+  bool lean_memory = false;
+  std::string perf_json;
+  size_t max_aggregated_proofs = 0;
+  base::FlagParser parser;
+  parser.AddFlag<base::Flag<size_t>>(&memory_limit_mb)
+      .set_long_name("--memory_limit_mb")
+      .set_help(
+          "Streams the zkey from disk, keeping the prover's memory under this "
+          "limit in MiB. By default, 0, which loads the whole zkey.");
+  parser.AddFlag<base::BoolFlag>(&check_r1cs)
+      .set_long_name("--check_r1cs")
+      .set_help(
+          "Whether to check the witness against the constraints before "
+          "proving. By default, false.");
+  parser.AddFlag<base::BoolFlag>(&lean_memory)
+      .set_long_name("--lean_memory")
+      .set_help(
+          "Whether to free the constraint matrices and the domain as soon as "
+          "they are dead. By default, false.");
+  parser.AddFlag<base::Flag<std::string>>(&perf_json)
+      .set_long_name("--perf_json")
+      .set_help(
+          "Writes the wall time, hardware counters and peak RSS of each "
+          "proving phase to this JSON file. By default, empty, which disables "
+          "profiling.");
+  parser.AddFlag<base::Flag<size_t>>(&max_aggregated_proofs)
+      .set_long_name("--max_aggregated_proofs")
+      .set_help(
+          "Benchmarks aggregating 2, 4, ... up to this many proofs, which "
+          "should be a power of two of at least 2. By default, 0, which "
+          "disables the benchmark.");
+  {
+    std::string error;
+    if (!parser.Parse(argc, argv, &error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+  }
+  if (memory_limit_mb > 0 && check_r1cs) {
+    std::cerr << "--check_r1cs can't be used with --memory_limit_mb"
+              << std::endl;
+    return 1;
+  }
+  if (memory_limit_mb > 0 && lean_memory) {
+    std::cerr << "--lean_memory can't be used with --memory_limit_mb"
+              << std::endl;
+    return 1;
+  }
+  if (memory_limit_mb > 0 && !perf_json.empty()) {
+    std::cerr << "--perf_json can't be used with --memory_limit_mb"
+              << std::endl;
+    return 1;
+  }
+  if (max_aggregated_proofs > 0) {
+    if (max_aggregated_proofs < 2 ||
+        (max_aggregated_proofs & (max_aggregated_proofs - 1))) {
+      std::cerr << "--max_aggregated_proofs should be a power of two of at "
+                   "least 2"
+                << std::endl;
+      return 1;
+    }
+    if (memory_limit_mb > 0) {
+      std::cerr << "--max_aggregated_proofs can't be used with "
+                   "--memory_limit_mb"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // Created before |Curve::Init()|, so that the counters are inherited by the
+  // OpenMP workers.
+  std::optional<PhaseProfiler> phase_profiler;
+  if (!perf_json.empty()) phase_profiler.emplace("rsa");
+  PhaseProfiler *profiler = phase_profiler ? &*phase_profiler : nullptr;
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+  constexpr size_t MaxDegree = (size_t{1} << 32) - 1;
+  using Domain = math::UnivariateEvaluationDomain<F, MaxDegree>;
+
+  Curve::Init();
+
+  if (memory_limit_mb > 0) {
+    return RunStreaming<Domain>(memory_limit_mb * 1024 * 1024);
+  }
+
+  auto zkey_start_time = std::chrono::high_resolution_clock::now();
+  zk::r1cs::groth16::ProvingKey<Curve> proving_key;
+  zk::r1cs::ConstraintMatrices<F> constraint_matrices;
+  {
+    ScopedPhase zkey_phase(profiler, "zkey");
+    ZKeyLoader<Curve> zkey_loader;
+    CHECK(zkey_loader.Load(base::FilePath("circuits/rsa/rsa_main.zkey"),
+                           &proving_key, &constraint_matrices));
+  }
+
+  auto zkey_end_time = std::chrono::high_resolution_clock::now();
+  auto zkey_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      zkey_end_time - zkey_start_time);
+
+  std::cout << "zkey time: " << zkey_duration.count() << " milliseconds"
+            << std::endl;
+
+  std::vector<F> full_assignments =
+      CalculateWitness(constraint_matrices.num_instance_variables +
+                           constraint_matrices.num_witness_variables,
+                       profiler);
 
   absl::Span<const F> public_inputs =
       absl::MakeConstSpan(full_assignments)
@@ -192,22 +443,67 @@ int RealMain(int argc, char **argv) {
   // CHECK_EQ(public_inputs.size(), size_t{256});
   // CheckPublicInput(in, public_inputs);
 
+  std::optional<R1CSChecker<F>> r1cs_checker;
+  if (check_r1cs) {
+    ScopedPhase r1cs_phase(profiler, "r1cs");
+    r1cs_checker.emplace();
+    CHECK(r1cs_checker->Load(base::FilePath("circuits/rsa/rsa_main.r1cs")));
+  }
+
+  std::cout << "Peak RSS before witness map: "
+            << ToMebibytes(GetPeakRSSInBytes()) << " MiB" << std::endl;
+
   auto prove_start_time = std::chrono::high_resolution_clock::now();
+  ScopedPhase prove_phase(profiler, "prove");
+  ScopedPhase witness_map_phase(profiler, "witness_map");
   std::unique_ptr<Domain> domain =
       Domain::Create(constraint_matrices.num_constraints +
                      constraint_matrices.num_instance_variables);
-  std::vector<F> h_evals =
-      QuadraticArithmeticProgram<F>::WitnessMapFromMatrices(
-          domain.get(), constraint_matrices, full_assignments);
-
-  zk::r1cs::groth16::Proof<Curve> proof =
-      zk::r1cs::groth16::CreateProofWithAssignmentZK(
-          proving_key, absl::MakeConstSpan(h_evals),
-          absl::MakeConstSpan(full_assignments)
-              .subspan(1, constraint_matrices.num_instance_variables - 1),
-          absl::MakeConstSpan(full_assignments)
-              .subspan(constraint_matrices.num_instance_variables),
-          absl::MakeConstSpan(full_assignments).subspan(1));
+  std::vector<F> h_evals;
+  if (r1cs_checker) {
+    std::optional<std::vector<F>> checked_h_evals =
+        r1cs_checker->WitnessMapFromMatrices(
+            domain.get(), &constraint_matrices, full_assignments,
+            /*release_matrices=*/lean_memory);
+    if (!checked_h_evals) {
+      std::cerr << "The witness doesn't satisfy the constraints" << std::endl;
+      return 1;
+    }
+    h_evals = std::move(*checked_h_evals);
+  } else if (lean_memory) {
+    h_evals = WitnessMap<F>::LeanWitnessMapFromMatrices(
+        domain.get(), &constraint_matrices, full_assignments);
+  } else {
+    h_evals = QuadraticArithmeticProgram<F>::WitnessMapFromMatrices(
+        domain.get(), constraint_matrices, full_assignments);
+  }
+  // Nothing but the MSMs is left, which need neither the domain nor the C
+  // matrix held by the checker.
+  if (lean_memory) {
+    domain.reset();
+    r1cs_checker.reset();
+  }
+  witness_map_phase.End();
+  std::cout << "Peak RSS after witness map: "
+            << ToMebibytes(GetPeakRSSInBytes()) << " MiB" << std::endl;
+
+  zk::r1cs::groth16::Proof<Curve> proof;
+  if (profiler) {
+    // Runs the MSMs one by one, so that each gets its own counters.
+    proof = CreateProofWithPhases(
+        proving_key, absl::MakeConstSpan(h_evals),
+        absl::MakeConstSpan(full_assignments),
+        constraint_matrices.num_instance_variables, profiler);
+  } else {
+    proof = zk::r1cs::groth16::CreateProofWithAssignmentZK(
+        proving_key, absl::MakeConstSpan(h_evals),
+        absl::MakeConstSpan(full_assignments)
+            .subspan(1, constraint_matrices.num_instance_variables - 1),
+        absl::MakeConstSpan(full_assignments)
+            .subspan(constraint_matrices.num_instance_variables),
+        absl::MakeConstSpan(full_assignments).subspan(1));
+  }
+  prove_phase.End();
   auto prove_end_time = std::chrono::high_resolution_clock::now();
   auto prove_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
       prove_end_time - prove_start_time);
@@ -215,17 +511,20 @@ int RealMain(int argc, char **argv) {
   std::cout << "Prove time: " << prove_duration.count() << " milliseconds"
             << std::endl;
 
-  auto end_time = std::chrono::high_resolution_clock::now();
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-      end_time - start_time);
-  std::cout << "====Total time: " << duration.count()
-            << " milliseconds====" << std::endl;
-  std::cout << proof.ToString() << std::endl;
-
   zk::r1cs::groth16::PreparedVerifyingKey<Curve> prepared_verifying_key =
       std::move(proving_key).TakeVerifyingKey().ToPreparedVerifyingKey();
-  CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key, proof,
-                                       public_inputs));
+  FinishProof(start_time, prepared_verifying_key, proof, public_inputs,
+              profiler);
+
+  if (max_aggregated_proofs > 0) {
+    RunAggregationBenchmark(prepared_verifying_key, proof, public_inputs,
+                            max_aggregated_proofs);
+  }
+
+  if (profiler && !profiler->WriteJson(perf_json)) {
+    std::cerr << "Failed to write " << perf_json << std::endl;
+    return 1;
+  }
   return 0;
 }
 
@@ -2,15 +2,19 @@
 #include <stdint.h>
 
 #include <iostream>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/types/span.h"
 #include "openssl/sha.h"
+#include "src/common/aggregation_benchmark.h"
+#include "src/common/rerandomize.h"
 
 #include "circomlib/circuit/quadratic_arithmetic_program.h"
 #include "circomlib/circuit/witness_loader.h"
 #include "circomlib/zkey/zkey_parser.h"
+#include "tachyon/base/flag/flag_parser.h"
 #include "tachyon/base/logging.h"
 #include "tachyon/math/elliptic_curves/bn/bn254/bn254.h"
 #include "tachyon/math/polynomials/univariate/univariate_evaluation_domain_factory.h"
@@ -63,6 +67,30 @@ void CheckPublicInput(const std::vector<uint8_t> &in,
 }
 
 int RealMain(int argc, char **argv) {
+  size_t max_aggregated_proofs = 0;
+  base::FlagParser parser;
+  parser.AddFlag<base::Flag<size_t>>(&max_aggregated_proofs)
+      .set_long_name("--max_aggregated_proofs")
+      .set_help(
+          "Benchmarks aggregating 2, 4, ... up to this many proofs, which "
+          "should be a power of two of at least 2. By default, 0, which "
+          "disables the benchmark.");
+  {
+    std::string error;
+    if (!parser.Parse(argc, argv, &error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+  }
+  if (max_aggregated_proofs > 0 &&
+      (max_aggregated_proofs < 2 ||
+       (max_aggregated_proofs & (max_aggregated_proofs - 1)))) {
+    std::cerr << "--max_aggregated_proofs should be a power of two of at "
+                 "least 2"
+              << std::endl;
+    return 1;
+  }
+
   auto start_time = std::chrono::high_resolution_clock::now();
   constexpr size_t MaxDegree = (size_t{1} << 16) - 1;
   using Domain = math::UnivariateEvaluationDomain<F, MaxDegree>;
@@ -150,6 +178,24 @@ int RealMain(int argc, char **argv) {
       std::move(proving_key).TakeVerifyingKey().ToPreparedVerifyingKey();
   CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key, proof,
                                        public_inputs));
+
+  auto rerandomize_start_time = std::chrono::high_resolution_clock::now();
+  zk::r1cs::groth16::Proof<Curve> rerandomized_proof =
+      RerandomizeProof(prepared_verifying_key.verifying_key(), proof);
+  auto rerandomize_end_time = std::chrono::high_resolution_clock::now();
+  auto rerandomize_duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          rerandomize_end_time - rerandomize_start_time);
+
+  std::cout << "Rerandomize time: " << rerandomize_duration.count()
+            << " microseconds" << std::endl;
+  CHECK(zk::r1cs::groth16::VerifyProof(prepared_verifying_key,
+                                       rerandomized_proof, public_inputs));
+
+  if (max_aggregated_proofs > 0) {
+    RunAggregationBenchmark(prepared_verifying_key, proof, public_inputs,
+                            max_aggregated_proofs);
+  }
   return 0;
 }
 